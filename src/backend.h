@@ -0,0 +1,95 @@
+/*
+Copyright (c) 2019, Integrated Design and Engineering Analysis Laboratory (IDEA Lab) at Iowa State University.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef BACKEND_H
+#define BACKEND_H
+
+#include <vector>
+
+#include "common.h"
+#include "shape.h"
+
+
+// Surface types of the faces
+enum SurfaceType {
+    SURFACE_PLANE,
+    SURFACE_CONE,
+    SURFACE_SPHERE,
+    SURFACE_TORUS,
+    SURFACE_SPLINE,
+    SURFACE_OTHER
+};
+
+// Geometry kernel backend interface
+class Backend {
+public:
+    virtual ~Backend() {}
+
+    // Start and stop the geometry kernel
+    virtual bool start(Config &) = 0;
+    virtual void stop(Config &) = 0;
+
+    // Load the model from the file
+    virtual bool load(const std::string &, Config &) = 0;
+
+    // Delete the loaded model, another model can be loaded afterwards
+    virtual void unload(Config &) = 0;
+
+    // Number of bodies in the model
+    virtual int bodyCount() = 0;
+
+    // Prepare the body for extraction and make it the current body
+    virtual bool beginBody(int, Config &, Statistics &) = 0;
+
+    // Delete the body and its converted geometry
+    virtual void releaseBody(int, Config &) = 0;
+
+    // Affine transformation (3x4 row-major matrix) of the current body
+    virtual bool bodyTransform(double *) = 0;
+
+    // Number of faces of the current body
+    virtual int faceCount() = 0;
+
+    // Face queries
+    virtual SurfaceType surfaceType(int) = 0;
+    virtual bool hasNamedAttribute(int, const std::string &) = 0;
+    virtual bool faceReversed(int) = 0;
+
+    // Convert the underlying geometry of the face to B-spline representation
+    virtual bool convertFace(int, Config &) = 0;
+
+    // Get the spline surface of the face with raw knots and control points, and its parametric offset and length
+    virtual bool getSurface(int, Config &, Surface &, double *, double *) = 0;
+
+    // Get the trim loops of the face with raw trim curves
+    virtual bool getTrims(int, Config &, std::vector<TrimLoop> &) = 0;
+};
+
+// Function prototypes
+Backend *createBackend(Config &);
+
+#endif /* BACKEND_H */
@@ -0,0 +1,589 @@
+/*
+Copyright (c) 2019, Integrated Design and Engineering Analysis Laboratory (IDEA Lab) at Iowa State University.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "backend_acis.h"
+#include "rwsat.h"
+
+
+// Flag to report the progress of the restore operation
+static bool loading = false;
+
+// Progress callback of ACIS, reports the restore progress and interrupts the running operation when its time budget is exceeded
+static int progressCallback(SPA_progress_info *info)
+{
+    if (loading && info != NULL)
+        progressLoad(info->percentage());
+    return budgetExpired() ? -1 : 0;
+}
+
+// Close the current delta state and remove it with the earlier states from the default history stream
+static void pruneHistory(Config &cfg)
+{
+    outcome res;
+    DELTA_STATE *ds = NULL;
+    {
+        ApiScope api("api_note_state");
+        res = api_note_state(ds);
+    }
+    if (!checkOutcome(res, "api_note_state", __LINE__, cfg) || ds == NULL)
+        return;
+    {
+        ApiScope api("api_prune_history");
+        res = api_prune_history(NULL, ds);
+    }
+    checkOutcome(res, "api_prune_history", __LINE__, cfg);
+}
+
+AcisBackend::AcisBackend() : body(NULL)
+{
+}
+
+// Use the entities restored by the caller (the modeller should be already started)
+AcisBackend::AcisBackend(ENTITY_LIST &entityList) : body(NULL)
+{
+    entityList.init();
+    ENTITY *ent;
+    while ((ent = entityList.next()) != NULL)
+        entities.add(ent);
+}
+
+bool AcisBackend::start(Config &cfg)
+{
+    // Initialize a variable to store ACIS API outcome
+    outcome res;
+
+    // Start ACIS
+    {
+        ApiScope api("api_start_modeller");
+        res = api_start_modeller();
+    }
+    if (!checkOutcome(res, "api_start_modeller", __LINE__, cfg))
+        return false;
+
+    // Unlock ACIS (required only on Windows)
+#ifdef _MSC_VER
+    if (!unlockACIS(cfg))
+        return false;
+#endif
+
+    // Report the progress and interrupt the long running operations when the time budgets are exceeded
+    if (cfg.face_timeout() > 0.0 || cfg.file_timeout() > 0.0 || cfg.progress() > 0.0)
+        set_progress_callback(progressCallback);
+
+    // Disable history and roll back information (bulletin boards) as undo is never used
+    if (!cfg.history())
+    {
+        res = api_logging(FALSE);
+        checkOutcome(res, "api_logging", __LINE__, cfg);
+    }
+
+    return true;
+}
+
+void AcisBackend::stop(Config &cfg)
+{
+    // Stop ACIS
+    outcome res;
+    {
+        ApiScope api("api_stop_modeller");
+        res = api_stop_modeller();
+    }
+    checkOutcome(res, "api_stop_modeller", __LINE__, cfg);
+}
+
+bool AcisBackend::load(const std::string &fileName, Config &cfg)
+{
+    // Read the SAT file into an ENTITY_LIST
+    std::string fname(fileName);
+    loading = true;
+    bool retVal = readSatFile(fname, entities, cfg);
+    loading = false;
+    return retVal;
+}
+
+void AcisBackend::unload(Config &cfg)
+{
+    // Initialize a variable to store ACIS API outcome
+    outcome res;
+
+    // Delete the remaining entities (the released bodies are already deleted)
+    entities.init();
+    ENTITY *ent;
+    while ((ent = entities.next()) != NULL)
+    {
+        {
+            ApiScope api("api_del_entity");
+            res = api_del_entity(ent);
+        }
+        checkOutcome(res, "api_del_entity", __LINE__, cfg);
+    }
+    entities.clear();
+    faces.clear();
+    body = NULL;
+
+    // Discard the bulletin board entries of the deleted entities
+    if (cfg.history())
+        pruneHistory(cfg);
+}
+
+// Number of the bodies of the loaded model, the removed entries of the released bodies are counted
+int AcisBackend::bodyCount()
+{
+    return entities.count();
+}
+
+bool AcisBackend::beginBody(int bodyIdx, Config &cfg, Statistics &stats)
+{
+    // Initialize a variable to store ACIS API outcome
+    outcome res;
+
+    // Get current body
+    body = (BODY *)entities[bodyIdx];
+    faces.clear();
+
+    // Errors are contained in the body, the changes are rolled back
+    API_BEGIN
+
+        // Workaround for periodic faces
+        {
+            PhaseScope splitPhase(PHASE_SPLIT);
+            stats.facesSplit += splitPeriodicFaces(body, cfg);
+        }
+
+        // Remove transformations
+        if (!cfg.transform())
+        {
+            {
+                ApiScope api("api_remove_transf");
+                res = api_remove_transf(body);
+            }
+            requireOutcome(res, "api_remove_transf", __LINE__, cfg);
+        }
+
+        // Get the face list
+        {
+            ApiScope api("api_get_faces");
+            res = api_get_faces(body, faces);
+        }
+        requireOutcome(res, "api_get_faces", __LINE__, cfg);
+
+    API_END
+
+    if (!result.ok())
+    {
+        faces.clear();
+        return false;
+    }
+
+    return true;
+}
+
+void AcisBackend::releaseBody(int bodyIdx, Config &cfg)
+{
+    // Initialize a variable to store ACIS API outcome
+    outcome res;
+
+    // Deleting the body also deletes its attributes
+    BODY *releasedBody = (BODY *)entities[bodyIdx];
+    {
+        ApiScope api("api_del_entity");
+        res = api_del_entity(releasedBody);
+    }
+    checkOutcome(res, "api_del_entity", __LINE__, cfg);
+
+    // Removed entries keep their places in the list, the indices of the other bodies do not change
+    entities.remove(releasedBody);
+    if (releasedBody == body)
+    {
+        body = NULL;
+        faces.clear();
+    }
+
+    // Discard the bulletin board entries, otherwise the deleted entities are kept for roll back
+    if (cfg.history())
+        pruneHistory(cfg);
+}
+
+bool AcisBackend::bodyTransform(double *affine)
+{
+    getAffineMatrix(get_owner_transf(body), affine);
+    return true;
+}
+
+int AcisBackend::faceCount()
+{
+    return faces.iteration_count();
+}
+
+SurfaceType AcisBackend::surfaceType(int faceIdx)
+{
+    SURFACE *geom = ((FACE *)faces[faceIdx])->geometry();
+    if (geom == NULL)
+        return SURFACE_OTHER;
+
+    switch (geom->identity())
+    {
+    case PLANE_TYPE:
+        return SURFACE_PLANE;
+    case CONE_TYPE:
+        return SURFACE_CONE;
+    case SPHERE_TYPE:
+        return SURFACE_SPHERE;
+    case TORUS_TYPE:
+        return SURFACE_TORUS;
+    case SPLINE_TYPE:
+        return SURFACE_SPLINE;
+    default:
+        return SURFACE_OTHER;
+    }
+}
+
+bool AcisBackend::hasNamedAttribute(int faceIdx, const std::string &name)
+{
+    ATTRIB_GEN_NAME *attrib = NULL;
+    ApiScope api("api_find_named_attribute");
+    outcome res = api_find_named_attribute(faces[faceIdx], name.c_str(), attrib);
+    return res.ok() && attrib != NULL;
+}
+
+bool AcisBackend::faceReversed(int faceIdx)
+{
+    return bool(((FACE *)faces[faceIdx])->sense());
+}
+
+bool AcisBackend::convertFace(int faceIdx, Config &cfg)
+{
+    convert_to_spline_options convertOptions;
+    convertOptions.set_do_edges(true);
+    convertOptions.set_do_faces(true);
+    convertOptions.set_in_place(true);
+
+    // Errors are contained in the face, the changes are rolled back
+    API_BEGIN
+        outcome res;
+        {
+            ApiScope api("api_convert_to_spline");
+            res = api_convert_to_spline(faces[faceIdx], &convertOptions);
+        }
+        requireOutcome(res, "api_convert_to_spline", __LINE__, cfg);
+    API_END
+
+    return result.ok();
+}
+
+bool AcisBackend::getSurface(int faceIdx, Config &cfg, Surface &surf, double *paramOffset, double *paramLength)
+{
+    bool retVal = false;
+
+    // Errors raised while evaluating the face geometry are contained in the face
+    API_NOP_BEGIN
+        retVal = readSurface((FACE *)faces[faceIdx], cfg, surf, paramOffset, paramLength);
+    API_NOP_END
+
+    return result.ok() && retVal;
+}
+
+bool AcisBackend::getTrims(int faceIdx, Config &cfg, std::vector<TrimLoop> &trims)
+{
+    bool retVal = false;
+
+    // Errors raised while evaluating the face geometry are contained in the face
+    API_NOP_BEGIN
+        retVal = readTrims(faces[faceIdx], cfg, trims);
+    API_NOP_END
+
+    return result.ok() && retVal;
+}
+
+// Read the spline surface of the face
+bool AcisBackend::readSurface(FACE *f, Config &cfg, Surface &surf, double *paramOffset, double *paramLength)
+{
+    // Fit tolerance of the spline approximations (negative value selects the ACIS default)
+    double fitTol = (cfg.fit_tolerance() > 0.0) ? cfg.fit_tolerance() : -1.0;
+
+    // Extract the spline surface from the face (transformation is applied to the extracted control points)
+    const surface &eqn = f->geometry()->equation();
+    const spline &spsurf = (spline &)eqn;
+    bs3_surface bsurf;
+    bool refitted = false;
+    double actualTol = 0.0;
+    if (fitTol > 0.0 && spsurf.fitol() > 0.0 && fitTol > spsurf.fitol())
+    {
+        // spline::sur returns the existing, tighter approximation for a looser tolerance, the surface is fitted again
+        // to get fewer control points (exact splines, e.g. the converted analytic surfaces, have no fit tolerance)
+        {
+            ApiScope api("bs3_surface_fit");
+            bsurf = bs3_surface_fit(fitTol, spsurf, spsurf.param_range(), actualTol);
+        }
+        refitted = (bsurf != NULL);
+    }
+    if (!refitted)
+    {
+        ApiScope api("spline::sur");
+        bsurf = spsurf.sur(fitTol);
+    }
+
+    // Check if ACIS was able to compute the B-spline representation
+    if (bsurf == NULL)
+        return false;
+
+    // Get the parametric range of the initial surface
+    SPAinterval u_range = bs3_surface_range_u(bsurf);
+    SPAinterval v_range = bs3_surface_range_v(bsurf);
+
+    // Length of the parametric dimensions
+    paramLength[0] = u_range.length();
+    paramLength[1] = v_range.length();
+
+    // Offset of the parametric dimensions (not to get negative parameters for trim curves)
+    paramOffset[0] = u_range.start_pt();
+    paramOffset[1] = v_range.start_pt();
+
+    // Surface spatial dimension
+    int dim;
+
+    // Surface form = 0 (open -clamped-), 1 (closed -unclamped-), 2 (periodic)
+    int form_u, form_v;
+
+    // Flag indicating the existence of poles (singularities)
+    int pole_u, pole_v;
+
+    // Rational/non-rational flag
+    int rat_u, rat_v;
+
+    // Degrees
+    int degree_u, degree_v;
+
+    // Knot vectors
+    int num_knots_u, num_knots_v;
+    double *knots_u;
+    double *knots_v;
+
+    // Extract control points and weights (weights != NULL if rational)
+    int num_u, num_v;
+    SPAposition *ctrlpts;
+    double *weights;
+
+    // Extract surface data
+    {
+        ApiScope api("bs3_surface_to_array");
+        bs3_surface_to_array(bsurf, dim, rat_u, rat_v, form_u, form_v, pole_u, pole_v,
+            num_u, num_v, ctrlpts, weights,
+            degree_u, num_knots_u, knots_u,
+            degree_v, num_knots_v, knots_v
+        );
+    }
+
+    // Update the surface with the extracted data
+    surf.rational = (rat_u || rat_v) ? true : false;
+    surf.degree_u = degree_u;
+    surf.degree_v = degree_v;
+    surf.knotvector_u.assign(knots_u, knots_u + num_knots_u);
+    surf.knotvector_v.assign(knots_v, knots_v + num_knots_v);
+    surf.size_u = num_u;
+    surf.size_v = num_v;
+    surf.ctrlpts.resize(3 * num_u * num_v);
+    for (int idx = 0; idx < num_u * num_v; idx++)
+    {
+        for (int c = 0; c < 3; c++)
+            surf.ctrlpts[3 * idx + c] = ctrlpts[idx].coordinate(c);
+    }
+    if (weights != nullptr)
+        surf.weights.assign(weights, weights + num_u * num_v);
+    else
+        surf.weights.clear();
+
+    // Delete arrays
+    free(knots_u);
+    free(knots_v);
+    free(ctrlpts);
+    if (weights != NULL)
+        free(weights);
+
+    // The surface fitted again is owned by this function, the approximation returned by spline::sur by the face
+    if (refitted)
+    {
+        bs3_surface_delete(bsurf);
+        if (logEnabled(LOG_DEBUG))
+        {
+            std::ostringstream msg;
+            msg << "Surface was fitted again to tolerance " << fitTol << " (previous " << spsurf.fitol() << ", actual " << actualTol
+                << "): " << num_u << " x " << num_v << " control points";
+            logMessage(LOG_DEBUG, "fit", msg.str());
+        }
+    }
+
+    return true;
+}
+
+// Read the trim loops of the face
+bool AcisBackend::readTrims(ENTITY *face, Config &cfg, std::vector<TrimLoop> &trims)
+{
+    // Initialize a variable to store ACIS API outcome
+    outcome res;
+
+    // Get the list of loops (face boundaries)
+    ENTITY_LIST loop_list;
+    {
+        ApiScope api("api_get_loops");
+        res = api_get_loops(face, loop_list);
+    }
+    requireOutcome(res, "api_get_loops", __LINE__, cfg);
+
+    // Get number of loops
+    int loop_count = loop_list.iteration_count();
+
+    trims.resize(loop_count);
+    for (int lid = 0; lid < loop_count; lid++)
+    {
+        // Get the current loop
+        LOOP *currLoop = (LOOP *)loop_list[lid];
+
+        // Get the coedges
+        ENTITY_LIST coedge_list;
+        {
+            ApiScope api("api_get_coedges");
+            res = api_get_coedges(currLoop, coedge_list);
+        }
+        requireOutcome(res, "api_get_coedges", __LINE__, cfg);
+
+        // Get the number of coedges
+        int coedge_count = coedge_list.iteration_count();
+
+        // Detect loop type
+        loop_type currLoopType;
+        {
+            ApiScope api("api_loop_type");
+            res = api_loop_type(currLoop, currLoopType);
+        }
+        requireOutcome(res, "api_loop_type", __LINE__, cfg);
+
+        TrimLoop &trimLoop = trims[lid];
+        trimLoop.type = currLoopType;
+        switch (currLoopType)
+        {
+        case loop_type::loop_hole:      // closed loop
+            trimLoop.reversed = 0;
+            break;
+        case loop_type::loop_periphery: // closed loop
+            trimLoop.reversed = 1;
+            break;
+        default:
+            trimLoop.reversed = -1;
+        }
+
+        // Loop through the trim curves
+        trimLoop.curves.resize(coedge_count);
+        for (int ce = 0; ce < coedge_count; ce++)
+        {
+            // Get the current coedge
+            COEDGE *coedge = (COEDGE *)coedge_list[ce];
+
+            // Extract the spline geometry from the parametric curve object (not affected by the transformation)
+            pcurve parametric_curve = coedge->geometry()->equation();
+            bs2_curve bcurve2d;
+            {
+                ApiScope api("pcurve::cur");
+                bcurve2d = parametric_curve.cur();
+            }
+
+            // Curve spatial dimension
+            int cdim;
+
+            // Rational/non-rational flag
+            int crat;
+
+            // Curve degree
+            int cdegree;
+
+            // Knot vector
+            int num_cknots;
+            double *cknots;
+
+            // Control points (parametric coordinates as [u,v,0])
+            int num_cctrlpts;
+            SPAposition *cctrlpts;
+            double *cweights;
+
+            // Extract trim curve data
+            {
+                ApiScope api("bs2_curve_to_array");
+                bs2_curve_to_array(bcurve2d, cdim, cdegree, crat, num_cctrlpts, cctrlpts, cweights, num_cknots, cknots);
+            }
+
+            // Update the trim curve with the extracted data
+            TrimCurve &curve = trimLoop.curves[ce];
+            curve.reversed = bool(coedge->sense());
+            curve.rational = bool(crat);
+            curve.degree = cdegree;
+            curve.knotvector.assign(cknots, cknots + num_cknots);
+            curve.ctrlpts.resize(2 * num_cctrlpts);
+            for (int idx = 0; idx < num_cctrlpts; idx++)
+            {
+                for (int c = 0; c < 2; c++)
+                    curve.ctrlpts[2 * idx + c] = cctrlpts[idx].coordinate(c);
+            }
+            if (cweights != nullptr)
+                curve.weights.assign(cweights, cweights + num_cctrlpts);
+            else
+                curve.weights.clear();
+
+            // Delete arrays
+            free(cknots);
+            free(cctrlpts);
+            if (cweights != NULL)
+                free(cweights);
+        }
+    }
+
+    return true;
+}
+
+// Compute the 3x4 row-major affine matrix [A | t] of the transformation, i.e. p' = A * p + t
+void getAffineMatrix(const SPAtransf &transf, double *m)
+{
+    // Map the origin and the unit vectors to find the columns of the matrix
+    SPAposition origin = SPAposition(0, 0, 0) * transf;
+    SPAposition axes[3] = {
+        SPAposition(1, 0, 0) * transf,
+        SPAposition(0, 1, 0) * transf,
+        SPAposition(0, 0, 1) * transf
+    };
+    for (int r = 0; r < 3; r++)
+    {
+        for (int c = 0; c < 3; c++)
+            m[4 * r + c] = axes[c].coordinate(r) - origin.coordinate(r);
+        m[4 * r + 3] = origin.coordinate(r);
+    }
+}
+
+// Extract the selected bodies of the entity list
+bool extractEntities(ENTITY_LIST &entities, Config &cfg, Statistics &stats, std::vector<Shape> &shapes)
+{
+    AcisBackend backend(entities);
+    return extractShapes(backend, cfg, stats, shapes);
+}
@@ -0,0 +1,71 @@
+/*
+Copyright (c) 2019, Integrated Design and Engineering Analysis Laboratory (IDEA Lab) at Iowa State University.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef BACKEND_ACIS_H
+#define BACKEND_ACIS_H
+
+#include "backend.h"
+#include "common_acis.h"
+
+
+// ACIS geometry kernel backend
+class AcisBackend : public Backend {
+public:
+    AcisBackend();
+    explicit AcisBackend(ENTITY_LIST &);
+
+    bool start(Config &);
+    void stop(Config &);
+    bool load(const std::string &, Config &);
+    void unload(Config &);
+    int bodyCount();
+    bool beginBody(int, Config &, Statistics &);
+    void releaseBody(int, Config &);
+    bool bodyTransform(double *);
+    int faceCount();
+    SurfaceType surfaceType(int);
+    bool hasNamedAttribute(int, const std::string &);
+    bool faceReversed(int);
+    bool convertFace(int, Config &);
+    bool getSurface(int, Config &, Surface &, double *, double *);
+    bool getTrims(int, Config &, std::vector<TrimLoop> &);
+
+private:
+    ENTITY_LIST entities;
+    BODY *body;
+    ENTITY_LIST faces;
+
+    // Methods
+    bool readSurface(FACE *, Config &, Surface &, double *, double *);
+    bool readTrims(ENTITY *, Config &, std::vector<TrimLoop> &);
+};
+
+// Function prototypes
+void getAffineMatrix(const SPAtransf &, double *);
+bool extractEntities(ENTITY_LIST &, Config &, Statistics &, std::vector<Shape> &);
+
+#endif /* BACKEND_ACIS_H */
@@ -0,0 +1,307 @@
+/*
+Copyright (c) 2019, Integrated Design and Engineering Analysis Laboratory (IDEA Lab) at Iowa State University.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "backend_mock.h"
+
+
+// Names of the surface types
+static const char *mockTypeNames[] = { "plane", "cone", "sphere", "torus", "spline" };
+
+MockBackend::MockBackend() : numBodies(0), numFaces(0), size(0), degree(0), numLoops(0), numCoedges(0), seed(0), failureRate(0.0), delay(0), body(-1)
+{
+}
+
+bool MockBackend::start(Config &)
+{
+    return true;
+}
+
+void MockBackend::stop(Config &)
+{
+}
+
+// The model is generated from the configuration, the file name is not used
+bool MockBackend::load(const std::string &, Config &cfg)
+{
+    numBodies = std::max(cfg.mock_bodies(), 0);
+    numFaces = std::max(cfg.mock_faces(), 0);
+    degree = std::max(cfg.mock_degree(), 1);
+    size = std::max(cfg.mock_size(), degree + 1);
+    numLoops = std::max(cfg.mock_loops(), 0);
+    numCoedges = std::max(cfg.mock_coedges(), 1);
+    seed = (unsigned int)cfg.mock_seed();
+    failureRate = cfg.mock_failures();
+    delay = std::max(cfg.mock_delay(), 0);
+    return true;
+}
+
+void MockBackend::unload(Config &)
+{
+    numBodies = 0;
+    body = -1;
+}
+
+int MockBackend::bodyCount()
+{
+    return numBodies;
+}
+
+bool MockBackend::beginBody(int bodyIdx, Config &, Statistics &)
+{
+    body = bodyIdx;
+    converted.assign(numFaces, false);
+    return true;
+}
+
+void MockBackend::releaseBody(int, Config &)
+{
+    // Faces are generated on demand, nothing to release
+}
+
+// Bodies are rotated around z-axis and translated along x-axis
+bool MockBackend::bodyTransform(double *affine)
+{
+    double angle = 0.25 * body;
+    double m[12] = {
+        std::cos(angle), -std::sin(angle), 0.0, 10.0 * body,
+        std::sin(angle), std::cos(angle), 0.0, 0.0,
+        0.0, 0.0, 1.0, 0.0
+    };
+    std::copy(m, m + 12, affine);
+    return true;
+}
+
+int MockBackend::faceCount()
+{
+    return numFaces;
+}
+
+// Face types cycle through plane, cone, sphere, torus and spline; converted faces have spline surfaces
+SurfaceType MockBackend::surfaceType(int faceIdx)
+{
+    if (converted[faceIdx])
+        return SURFACE_SPLINE;
+    return SurfaceType(faceIdx % 5);
+}
+
+// Each face has a named attribute "mock_" followed by its original surface type, e.g. "mock_torus"
+bool MockBackend::hasNamedAttribute(int faceIdx, const std::string &name)
+{
+    return name == std::string("mock_") + mockTypeNames[faceIdx % 5];
+}
+
+bool MockBackend::faceReversed(int faceIdx)
+{
+    return (faceIdx / 5) % 2 == 1;
+}
+
+bool MockBackend::convertFace(int faceIdx, Config &)
+{
+    if (faceFails(faceIdx, 0))
+        return false;
+
+    // Simulated conversion time, interrupted like the geometry kernel operations when the time budget is exceeded
+    std::chrono::steady_clock::time_point finish = std::chrono::steady_clock::now() + std::chrono::milliseconds(delay);
+    while (std::chrono::steady_clock::now() < finish)
+    {
+        if (budgetExpired())
+            return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    converted[faceIdx] = true;
+    return true;
+}
+
+bool MockBackend::getSurface(int faceIdx, Config &, Surface &surf, double *paramOffset, double *paramLength)
+{
+    if (faceFails(faceIdx, 1))
+        return false;
+
+    std::mt19937 gen = faceGenerator(faceIdx, 0);
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+
+    // Parametric domain, not starting from zero to exercise the normalization
+    for (int d = 0; d < 2; d++)
+    {
+        paramOffset[d] = 2.0 * dist(gen) - 1.0;
+        paramLength[d] = 1.0 + 2.0 * dist(gen);
+    }
+
+    // Clamped uniform knot vectors
+    surf.degree_u = degree;
+    surf.degree_v = degree;
+    surf.size_u = size;
+    surf.size_v = size;
+    std::vector<double> *knotvectors[2] = { &surf.knotvector_u, &surf.knotvector_v };
+    for (int d = 0; d < 2; d++)
+    {
+        std::vector<double> &kv = *knotvectors[d];
+        kv.resize(size + degree + 1);
+        for (int k = 0; k < size + degree + 1; k++)
+        {
+            int span = std::min(std::max(k - degree, 0), size - degree);
+            kv[k] = paramOffset[d] + paramLength[d] * double(span) / double(size - degree);
+        }
+    }
+
+    // Control points on a perturbed grid
+    surf.ctrlpts.resize(3 * size * size);
+    for (int ku = 0; ku < size; ku++)
+    {
+        for (int kv = 0; kv < size; kv++)
+        {
+            int idx = kv + (size * ku);
+            surf.ctrlpts[3 * idx] = double(ku) + 0.1 * dist(gen);
+            surf.ctrlpts[3 * idx + 1] = double(kv) + 0.1 * dist(gen);
+            surf.ctrlpts[3 * idx + 2] = dist(gen) - 0.5;
+        }
+    }
+
+    // Converted analytic surfaces (except planes) are rational
+    SurfaceType origType = SurfaceType(faceIdx % 5);
+    surf.rational = (origType != SURFACE_PLANE && origType != SURFACE_SPLINE);
+    surf.weights.clear();
+    if (surf.rational)
+    {
+        surf.weights.resize(size * size);
+        for (int idx = 0; idx < size * size; idx++)
+            surf.weights[idx] = 0.7 + 0.3 * dist(gen);
+    }
+
+    return true;
+}
+
+bool MockBackend::getTrims(int faceIdx, Config &, std::vector<TrimLoop> &trims)
+{
+    if (faceFails(faceIdx, 2))
+        return false;
+
+    // Use the same parametric domain with the surface
+    std::mt19937 gen = faceGenerator(faceIdx, 0);
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    double offset[2], length[2];
+    for (int d = 0; d < 2; d++)
+    {
+        offset[d] = 2.0 * dist(gen) - 1.0;
+        length[d] = 1.0 + 2.0 * dist(gen);
+    }
+
+    trims.resize(numLoops);
+    for (int lid = 0; lid < numLoops; lid++)
+    {
+        TrimLoop &trimLoop = trims[lid];
+        trimLoop.curves.resize(numCoedges);
+        if (lid == 0)
+        {
+            // Periphery: boundary of the parametric domain as linear trim curves
+            trimLoop.type = TRIM_LOOP_PERIPHERY;
+            trimLoop.reversed = 1;
+            const double corners[5][2] = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 }, { 0, 0 } };
+            for (int ce = 0; ce < numCoedges; ce++)
+            {
+                TrimCurve &curve = trimLoop.curves[ce];
+                curve.reversed = false;
+                curve.rational = false;
+                curve.degree = 1;
+                curve.ctrlpts.clear();
+                curve.weights.clear();
+
+                // Parameters on the perimeter, including the corners in between
+                double t0 = 4.0 * ce / numCoedges;
+                double t1 = 4.0 * (ce + 1) / numCoedges;
+                std::vector<double> params;
+                params.push_back(t0);
+                for (int c = int(std::floor(t0)) + 1; c < t1; c++)
+                    params.push_back(double(c));
+                params.push_back(t1);
+
+                curve.knotvector.clear();
+                curve.knotvector.push_back(params.front());
+                for (std::size_t pi = 0; pi < params.size(); pi++)
+                {
+                    double t = params[pi];
+                    int side = std::min(int(std::floor(t)), 3);
+                    double s = t - side;
+                    for (int d = 0; d < 2; d++)
+                    {
+                        double uv = corners[side][d] + s * (corners[side + 1][d] - corners[side][d]);
+                        curve.ctrlpts.push_back(offset[d] + length[d] * uv);
+                    }
+                    curve.knotvector.push_back(t);
+                }
+                curve.knotvector.push_back(params.back());
+            }
+        }
+        else
+        {
+            // Holes: circles as rational quadratic trim curves
+            trimLoop.type = TRIM_LOOP_HOLE;
+            trimLoop.reversed = 0;
+            double center[2] = { offset[0] + length[0] * (lid - 0.5) / (numLoops - 1), offset[1] + 0.5 * length[1] };
+            double radius = 0.3 * std::min(length[0] / (numLoops - 1), length[1]);
+            double sweep = 2.0 * std::acos(-1.0) / numCoedges;
+            for (int ce = 0; ce < numCoedges; ce++)
+            {
+                TrimCurve &curve = trimLoop.curves[ce];
+                curve.reversed = true;
+                curve.rational = true;
+                curve.degree = 2;
+                curve.knotvector = { 0.0, 0.0, 0.0, 1.0, 1.0, 1.0 };
+                double a0 = sweep * ce;
+                double am = a0 + 0.5 * sweep;
+                double a1 = a0 + sweep;
+                double rm = radius / std::cos(0.5 * sweep);
+                curve.ctrlpts = {
+                    center[0] + radius * std::cos(a0), center[1] + radius * std::sin(a0),
+                    center[0] + rm * std::cos(am), center[1] + rm * std::sin(am),
+                    center[0] + radius * std::cos(a1), center[1] + radius * std::sin(a1)
+                };
+                curve.weights = { 1.0, std::cos(0.5 * sweep), 1.0 };
+            }
+        }
+    }
+
+    return true;
+}
+
+// Random number generator of the face, the same sequence is generated for the same face and stream
+std::mt19937 MockBackend::faceGenerator(int faceIdx, unsigned int stream)
+{
+    std::seed_seq seq = { seed, (unsigned int)body, (unsigned int)faceIdx, stream };
+    return std::mt19937(seq);
+}
+
+// Simulated failures: the selected faces fail at one of the conversion (0), surface (1) or trim (2) stages
+bool MockBackend::faceFails(int faceIdx, int stage)
+{
+    if (failureRate <= 0.0)
+        return false;
+    std::mt19937 gen = faceGenerator(faceIdx, 1);
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    return dist(gen) < failureRate && faceIdx % 3 == stage;
+}
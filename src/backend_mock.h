@@ -0,0 +1,81 @@
+/*
+Copyright (c) 2019, Integrated Design and Engineering Analysis Laboratory (IDEA Lab) at Iowa State University.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef BACKEND_MOCK_H
+#define BACKEND_MOCK_H
+
+#include <random>
+#include <chrono>
+#include <thread>
+
+#include "backend.h"
+#include "budget.h"
+
+
+// Synthetic in-memory geometry backend for testing and benchmarking without a geometry kernel license
+class MockBackend : public Backend {
+public:
+    MockBackend();
+
+    bool start(Config &);
+    void stop(Config &);
+    bool load(const std::string &, Config &);
+    void unload(Config &);
+    int bodyCount();
+    bool beginBody(int, Config &, Statistics &);
+    void releaseBody(int, Config &);
+    bool bodyTransform(double *);
+    int faceCount();
+    SurfaceType surfaceType(int);
+    bool hasNamedAttribute(int, const std::string &);
+    bool faceReversed(int);
+    bool convertFace(int, Config &);
+    bool getSurface(int, Config &, Surface &, double *, double *);
+    bool getTrims(int, Config &, std::vector<TrimLoop> &);
+
+private:
+    // Model parameters
+    int numBodies;
+    int numFaces;
+    int size;
+    int degree;
+    int numLoops;
+    int numCoedges;
+    unsigned int seed;
+    double failureRate;
+    int delay;
+
+    // Current body
+    int body;
+    std::vector<bool> converted;
+
+    // Methods
+    std::mt19937 faceGenerator(int, unsigned int);
+    bool faceFails(int, int);
+};
+
+#endif /* BACKEND_MOCK_H */
@@ -0,0 +1,263 @@
+/*
+Copyright (c) 2019, Integrated Design and Engineering Analysis Laboratory (IDEA Lab) at Iowa State University.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "batch.h"
+#include "rwsat.h"
+
+#include <chrono>
+#include <memory>
+
+
+Journal::Journal(const std::string &name) : fileName(name)
+{
+}
+
+// Read and compact the journal of the interrupted run, or start a new journal
+bool Journal::open(bool resume)
+{
+    if (resume)
+        load();
+    return save();
+}
+
+// Read the journal of a previous run (one JSON object per line, a later entry of a file replaces the earlier ones)
+bool Journal::load()
+{
+    std::ifstream fileRead(fileName.c_str());
+    if (!fileRead)
+        return false;
+
+    Json::CharReaderBuilder rbuilder;
+    std::unique_ptr<Json::CharReader> reader(rbuilder.newCharReader());
+    std::string line;
+    while (std::getline(fileRead, line))
+    {
+        Json::Value entryDef;
+        std::string errs;
+        if (line.empty() || !reader->parse(line.data(), line.data() + line.size(), &entryDef, &errs))
+            continue;
+        deserializeJournalEntry(entryDef, entry(entryDef["input"].asString()));
+    }
+    return true;
+}
+
+// Write the journal to a temporary file and replace the journal with it, an interrupted run leaves a complete journal
+// (used only when the journal is opened, the later updates are appended)
+bool Journal::save()
+{
+    Json::StreamWriterBuilder wbuilder;
+    wbuilder["indentation"] = "";
+
+    std::string tmpName = fileName + ".tmp";
+    std::ofstream fileSave(tmpName.c_str(), std::ios::out | std::ios::trunc);
+    if (!fileSave)
+    {
+        logMessage(LOG_ERROR, "file", "Cannot open file '" + tmpName + "' for writing!");
+        return false;
+    }
+    for (std::size_t j = 0; j < entries.size(); j++)
+    {
+        Json::Value entryDef;
+        serializeJournalEntry(entries[j], entryDef);
+        fileSave << Json::writeString(wbuilder, entryDef) << "\n";
+    }
+    fileSave.close();
+    if (!fileSave || std::rename(tmpName.c_str(), fileName.c_str()) != 0)
+    {
+        logMessage(LOG_ERROR, "file", "Cannot write to file '" + fileName + "'!");
+        return false;
+    }
+    return true;
+}
+
+// Append the updated entry to the journal, a partially written line of an interrupted run is skipped on load
+bool Journal::append(const JournalEntry &e)
+{
+    Json::StreamWriterBuilder wbuilder;
+    wbuilder["indentation"] = "";
+    Json::Value entryDef;
+    serializeJournalEntry(e, entryDef);
+
+    std::ofstream fileSave(fileName.c_str(), std::ios::out | std::ios::app);
+    fileSave << Json::writeString(wbuilder, entryDef) << "\n";
+    fileSave.close();
+    if (!fileSave)
+    {
+        logMessage(LOG_ERROR, "file", "Cannot write to file '" + fileName + "'!");
+        return false;
+    }
+    return true;
+}
+
+// Find the entry of the input file or add a new one
+JournalEntry &Journal::entry(const std::string &input)
+{
+    std::map<std::string, std::size_t>::iterator it = index.find(input);
+    if (it != index.end())
+        return entries[it->second];
+    index[input] = entries.size();
+    entries.push_back(JournalEntry());
+    entries.back().input = input;
+    return entries.back();
+}
+
+// Check if the input file was converted successfully (the started, failed and crashed files are converted again)
+bool Journal::completed(const std::string &input)
+{
+    std::map<std::string, std::size_t>::iterator it = index.find(input);
+    return it != index.end() && entries[it->second].status == "done";
+}
+
+// Convert the journal entry to JSON (also used for reporting the results of the worker processes)
+void serializeJournalEntry(const JournalEntry &e, Json::Value &entryDef)
+{
+    entryDef["input"] = e.input;
+    entryDef["status"] = e.status;
+    entryDef["outputs"] = Json::Value(Json::arrayValue);
+    for (std::size_t i = 0; i < e.outputs.size(); i++)
+        entryDef["outputs"].append(e.outputs[i]);
+    entryDef["bodies"] = e.stats.bodies;
+    entryDef["faces"] = e.stats.faces;
+    entryDef["faces_split"] = e.stats.facesSplit;
+    entryDef["surf_ctrlpts"] = Json::Int64(e.stats.surfCtrlpts);
+    entryDef["trim_ctrlpts"] = Json::Int64(e.stats.trimCtrlpts);
+    entryDef["bodies_failed"] = e.stats.bodiesFailed;
+    entryDef["faces_failed"] = e.stats.facesFailed;
+    entryDef["bodies_timed_out"] = e.stats.bodiesTimedOut;
+    entryDef["faces_timed_out"] = e.stats.facesTimedOut;
+    entryDef["seconds"] = e.seconds;
+}
+
+void deserializeJournalEntry(const Json::Value &entryDef, JournalEntry &e)
+{
+    e.input = entryDef["input"].asString();
+    e.status = entryDef["status"].asString();
+    e.outputs.clear();
+    for (Json::Value::ArrayIndex i = 0; i < entryDef["outputs"].size(); i++)
+        e.outputs.push_back(entryDef["outputs"][i].asString());
+    e.stats.bodies = entryDef["bodies"].asInt();
+    e.stats.faces = entryDef["faces"].asInt();
+    e.stats.facesSplit = entryDef["faces_split"].asInt();
+    e.stats.surfCtrlpts = entryDef["surf_ctrlpts"].asInt64();
+    e.stats.trimCtrlpts = entryDef["trim_ctrlpts"].asInt64();
+    e.stats.bodiesFailed = entryDef["bodies_failed"].asInt();
+    e.stats.facesFailed = entryDef["faces_failed"].asInt();
+    e.stats.bodiesTimedOut = entryDef["bodies_timed_out"].asInt();
+    e.stats.facesTimedOut = entryDef["faces_timed_out"].asInt();
+    e.seconds = entryDef["seconds"].asDouble();
+}
+
+// Read the input file names from the manifest (one file per line, empty lines and lines starting with # are skipped)
+bool readManifest(const std::string &fileName, std::vector<std::string> &inputs)
+{
+    std::ifstream fileRead(fileName.c_str());
+    if (!fileRead)
+    {
+        logMessage(LOG_ERROR, "file", "Cannot open file '" + fileName + "' for reading!");
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(fileRead, line))
+    {
+        std::size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#')
+            continue;
+        std::size_t last = line.find_last_not_of(" \t\r");
+        inputs.push_back(line.substr(first, last - first + 1));
+    }
+    return true;
+}
+
+// Convert the input file and record the result in the journal entry
+bool convertJob(Backend &backend, const std::string &input, Config &cfg, JournalEntry &e)
+{
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    e.input = input;
+    e.stats = Statistics();
+    e.outputs.clear();
+    bool converted = convertFile(backend, input, cfg, e.stats, e.outputs);
+    e.status = converted ? "done" : "failed";
+    e.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return converted;
+}
+
+// Convert the input files listed in the manifest with the started backend, keeping a journal of the processed files
+bool convertBatch(Backend &backend, const std::string &manifestName, Config &cfg, Statistics &stats)
+{
+    // Read the input file names
+    std::vector<std::string> inputs;
+    if (!readManifest(manifestName, inputs))
+        return false;
+
+    // Read the journal of the interrupted run or start a new one
+    Journal journal(cfg.journal().empty() ? manifestName + ".journal" : cfg.journal());
+    if (!journal.open(cfg.resume()))
+        return false;
+
+    // Count the files processed by the previous runs, the progress is estimated from the remaining files
+    int skipped = 0;
+    for (std::size_t i = 0; i < inputs.size(); i++)
+    {
+        if (cfg.resume() && journal.completed(inputs[i]))
+            skipped++;
+    }
+    int pending = int(inputs.size()) - skipped;
+
+    bool retVal = true;
+    int started = 0;
+    for (std::size_t i = 0; i < inputs.size(); i++)
+    {
+        const std::string &input = inputs[i];
+
+        // Skip the files processed by the previous runs
+        if (cfg.resume() && journal.completed(input))
+            continue;
+        progressFile(started++, pending);
+
+        // Mark the file as started, it is processed again on resume if the run is interrupted
+        journal.entry(input).status = "started";
+        if (!journal.append(journal.entry(input)))
+            return false;
+
+        // Convert the file
+        logMessage(LOG_INFO, "batch", "Converting file '" + input + "' (" + std::to_string(i + 1) + "/" + std::to_string(inputs.size()) + ")");
+        JournalEntry &e = journal.entry(input);
+        if (!convertJob(backend, input, cfg, e))
+            retVal = false;
+        addStatistics(stats, e.stats);
+
+        // Record the result
+        if (!journal.append(e))
+            return false;
+    }
+
+    if (skipped > 0)
+        logMessage(LOG_INFO, "batch", std::to_string(skipped) + " files were processed by the previous runs and skipped");
+
+    return retVal;
+}
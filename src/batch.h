@@ -0,0 +1,71 @@
+/*
+Copyright (c) 2019, Integrated Design and Engineering Analysis Laboratory (IDEA Lab) at Iowa State University.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <string>
+#include <vector>
+#include <map>
+
+#include "common.h"
+#include "backend.h"
+#include "json/json.h"
+
+
+// Journal entry of an input file of the batch
+struct JournalEntry {
+    std::string input;
+    std::string status;  // started, done, failed or crashed
+    std::vector<std::string> outputs;
+    Statistics stats;
+    double seconds = 0.0;
+};
+
+// Journal of the processed input files, the updated entries are appended (the last entry of a file is valid)
+struct Journal {
+    std::string fileName;
+    std::vector<JournalEntry> entries;
+    std::map<std::string, std::size_t> index;
+
+    explicit Journal(const std::string &);
+    bool open(bool);
+    bool load();
+    bool save();
+    bool append(const JournalEntry &);
+    JournalEntry &entry(const std::string &);
+    bool completed(const std::string &);
+};
+
+// Function prototypes
+void serializeJournalEntry(const JournalEntry &, Json::Value &);
+void deserializeJournalEntry(const Json::Value &, JournalEntry &);
+bool readManifest(const std::string &, std::vector<std::string> &);
+bool convertJob(Backend &, const std::string &, Config &, JournalEntry &);
+bool convertBatch(Backend &, const std::string &, Config &, Statistics &);
+
+#endif /* BATCH_H */
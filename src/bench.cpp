@@ -0,0 +1,422 @@
+/*
+Copyright (c) 2019, Integrated Design and Engineering Analysis Laboratory (IDEA Lab) at Iowa State University.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "rwsat.h"
+#include "backend_mock.h"
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <functional>
+
+
+// Benchmark configuration, the benchmark options are added to the common options
+struct BenchConfig : public Config {
+    BenchConfig();
+
+    // Methods
+    std::string bench_run();
+    double bench_min_time();
+    int bench_iterations();
+    std::string bench_output();
+};
+
+// Result of a benchmark, the counts are the totals of all iterations
+struct BenchResult {
+    std::string name;
+    int iterations = 0;
+    double seconds = 0.0;
+    long long faces = 0;
+    long long bytes = 0;
+};
+
+BenchConfig::BenchConfig()
+{
+    params.insert({
+        { "bench_run", { "", "Benchmarks to run: parse_config,extract_surface,extract_trims,serialize_json,convert (empty: all)" } },
+        { "bench_min_time", { "1", "Minimum time of each benchmark in seconds, the iterations are repeated until it is reached" } },
+        { "bench_iterations", { "0", "Number of iterations of each benchmark (0: repeat until 'bench_min_time')" } },
+        { "bench_output", { "", "Write the results to this file, one JSON object per line (empty: standard output)" } }
+    });
+
+    // Log only the problems, the results are written to standard output by default
+    params["log_level"].first = "warning";
+}
+
+std::string BenchConfig::bench_run()
+{
+    return params.at("bench_run").first;
+}
+
+double BenchConfig::bench_min_time()
+{
+    return std::atof(params.at("bench_min_time").first.c_str());
+}
+
+int BenchConfig::bench_iterations()
+{
+    return std::atoi(params.at("bench_iterations").first.c_str());
+}
+
+std::string BenchConfig::bench_output()
+{
+    return params.at("bench_output").first;
+}
+
+// Check if the benchmark is selected with 'bench_run' option
+static bool benchSelected(BenchConfig &cfg, const std::string &name)
+{
+    if (cfg.bench_run().empty())
+        return true;
+    std::stringstream ss(cfg.bench_run());
+    std::string token;
+    while (std::getline(ss, token, ','))
+    {
+        if (token == name)
+            return true;
+    }
+    return false;
+}
+
+// Reset the peak resident memory of the process (Linux), so the peak of each benchmark is measured separately
+static bool resetPeakMemory()
+{
+#ifdef __linux__
+    std::ofstream fileSave("/proc/self/clear_refs");
+    fileSave << "5" << std::endl;
+    return bool(fileSave);
+#else
+    return false;
+#endif
+}
+
+// Write the benchmark result as a JSON object in a single line
+static void writeResult(const BenchResult &result, std::size_t startRss, bool peakReset, std::ostream &out)
+{
+    Json::Value resultDef;
+    resultDef["name"] = result.name;
+    resultDef["iterations"] = result.iterations;
+    resultDef["wall_time"] = result.seconds;
+    resultDef["time_per_iteration"] = (result.iterations > 0) ? result.seconds / result.iterations : 0.0;
+    resultDef["faces_per_sec"] = (result.seconds > 0.0) ? result.faces / result.seconds : 0.0;
+    resultDef["bytes_per_sec"] = (result.seconds > 0.0) ? result.bytes / result.seconds : 0.0;
+    // The peak is the peak of the process if it cannot be reset, the increase over the memory at the start of
+    // the benchmark is comparable in both cases
+    std::size_t current, peak;
+    getMemoryUsage(current, peak);
+    resultDef["peak_rss"] = Json::UInt64(peak);
+    resultDef["peak_rss_increase"] = Json::UInt64((peak > startRss) ? peak - startRss : 0);
+    resultDef["peak_rss_reset"] = peakReset;
+
+    // The log messages of the benchmark are written before its result
+    Json::StreamWriterBuilder wbuilder;
+    wbuilder["indentation"] = "";
+    flushLog();
+    out << Json::writeString(wbuilder, resultDef) << std::endl;
+}
+
+// Run the benchmark after a warm-up iteration and write its result, returns false if any iteration fails
+static bool runBenchmark(BenchConfig &cfg, const std::string &name, std::ostream &out, const std::function<bool(BenchResult &)> &iteration)
+{
+    BenchResult result;
+    result.name = name;
+
+    // Memory at the start of the benchmark
+    bool peakReset = resetPeakMemory();
+    std::size_t startRss, startPeak;
+    getMemoryUsage(startRss, startPeak);
+
+    BenchResult warmup;
+    bool retVal = iteration(warmup);
+    auto timeStart = std::chrono::steady_clock::now();
+    while (retVal)
+    {
+        retVal = iteration(result);
+        result.iterations++;
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - timeStart).count();
+        if (cfg.bench_iterations() > 0 ? result.iterations >= cfg.bench_iterations() : result.seconds >= cfg.bench_min_time())
+            break;
+    }
+
+    if (!retVal)
+    {
+        logMessage(LOG_ERROR, "bench", "Benchmark '" + name + "' failed!");
+        return false;
+    }
+    writeResult(result, startRss, peakReset, out);
+    return true;
+}
+
+// Collect the raw surfaces and trim curves of the first mock body as the input of the micro benchmarks
+static bool prepareSurfaces(Config &cfg, std::vector<Surface> &surfaces)
+{
+    MockBackend mock;
+    Statistics stats;
+    if (!mock.start(cfg) || !mock.load("", cfg) || mock.bodyCount() == 0 || !mock.beginBody(0, cfg, stats))
+        return false;
+
+    for (int j = 0; j < mock.faceCount(); j++)
+    {
+        Surface surf;
+        double paramOffset[2];
+        double paramLength[2];
+        if (!mock.convertFace(j, cfg) || !mock.getSurface(j, cfg, surf, paramOffset, paramLength) || !mock.getTrims(j, cfg, surf.trims))
+            continue;
+        surf.id = j;
+        surf.face = j;
+        surf.hasTrims = true;
+        surfaces.push_back(surf);
+    }
+    mock.releaseBody(0, cfg);
+    mock.unload(cfg);
+    mock.stop(cfg);
+    return !surfaces.empty();
+}
+
+// Read and finalize the surfaces of the first body through the backend, the faces are converted before the timed
+// iterations (the conversion is measured by the end-to-end benchmark)
+static bool benchExtractSurface(BenchConfig &cfg, Backend &backend, const std::string &fileName, std::ostream &out)
+{
+    Statistics stats;
+    if (!backend.load(fileName, cfg))
+        return false;
+    if (backend.bodyCount() == 0 || !backend.beginBody(0, cfg, stats))
+    {
+        backend.unload(cfg);
+        return false;
+    }
+
+    // Use the faces which can be converted and extracted
+    std::vector<int> faces;
+    for (int j = 0; j < backend.faceCount(); j++)
+    {
+        Surface surf;
+        double paramOffset[2];
+        double paramLength[2];
+        if (backend.convertFace(j, cfg) && backend.surfaceType(j) == SURFACE_SPLINE && backend.getSurface(j, cfg, surf, paramOffset, paramLength))
+            faces.push_back(j);
+    }
+    double affine[12];
+    bool hasTransform = cfg.transform() && backend.bodyTransform(affine);
+
+    bool retVal = !faces.empty() && runBenchmark(cfg, "extract_surface", out, [&](BenchResult &r) {
+        for (std::size_t j = 0; j < faces.size(); j++)
+        {
+            Surface surf;
+            double paramOffset[2];
+            double paramLength[2];
+            if (!backend.getSurface(faces[j], cfg, surf, paramOffset, paramLength))
+                return false;
+            extractSurfaceData(surf, cfg, (hasTransform) ? affine : NULL);
+        }
+        r.faces += (long long)faces.size();
+        return true;
+    });
+
+    backend.unload(cfg);
+    return retVal;
+}
+
+// Find the total size of the files
+static long long fileSizes(const std::vector<std::string> &fileNames)
+{
+    long long bytes = 0;
+    for (std::size_t j = 0; j < fileNames.size(); j++)
+    {
+        std::ifstream fileRead(fileNames[j].c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+        if (fileRead)
+            bytes += (long long)fileRead.tellg();
+    }
+    return bytes;
+}
+
+// RWSAT_BENCH executable
+int main(int argc, char **argv)
+{
+    // Initialize configuration
+    BenchConfig cfg;
+
+    if (argc < 2 || argc > 3)
+    {
+        std::cout << "Usage: " << argv[0] << " FILENAME OPTIONS\n" << std::endl;
+        std::cout << "FILENAME is the model converted by the end-to-end benchmark, e.g. a satgen corpus ('-' skips it)." << std::endl;
+        std::cout << "The micro benchmarks use the surfaces of the mock backend configured by 'mock_*' options, 'extract_surface' reads" << std::endl;
+        std::cout << "the first body of FILENAME through the configured backend.\n" << std::endl;
+        std::cout << "Available options:" << std::endl;
+        for (auto p : cfg.params)
+            std::cout << "  - " << p.first << ": " << p.second.second << std::endl;
+        std::cout << "\nExample: " << argv[0] << " corpus.sat output_format=none;bench_output=results.jsonl" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::string fileName(argv[1]);
+
+    // Update configuration
+    std::string confStr = (argc == 3) ? argv[2] : "";
+    if (argc == 3)
+        parseConfig(argv[2], cfg);
+
+    // Set up logging
+    configureLog(cfg);
+
+    // Open the results file
+    std::ofstream fileSave;
+    if (!cfg.bench_output().empty())
+    {
+        fileSave.open(cfg.bench_output().c_str(), std::ios::out);
+        if (!fileSave)
+        {
+            logMessage(LOG_ERROR, "file", "Cannot open file '" + cfg.bench_output() + "' for writing!");
+            finishLog();
+            return EXIT_FAILURE;
+        }
+    }
+    std::ostream &out = cfg.bench_output().empty() ? std::cout : fileSave;
+
+    // Input of the micro benchmarks
+    std::vector<Surface> surfaces;
+    if (!prepareSurfaces(cfg, surfaces))
+    {
+        logMessage(LOG_ERROR, "bench", "Cannot generate the mock surfaces for the micro benchmarks!");
+        finishLog();
+        return EXIT_FAILURE;
+    }
+
+    bool retVal = true;
+
+    // Parse the option string of the command line, or a typical one
+    if (benchSelected(cfg, "parse_config"))
+    {
+        if (confStr.empty())
+            confStr = "normalize=1;trims=1;sense=1;transform=0;bspline=1;output_format=json;log_level=warning";
+        std::vector<char> confBuffer(confStr.begin(), confStr.end());
+        confBuffer.push_back('\0');
+
+        Config parsed;
+        retVal = runBenchmark(cfg, "parse_config", out, [&](BenchResult &) {
+            parseConfig(confBuffer.data(), parsed);
+            return true;
+        }) && retVal;
+    }
+
+    // Start the configured backend for the benchmarks reading the input file
+    std::unique_ptr<Backend> backend;
+    if (fileName != "-" && (benchSelected(cfg, "extract_surface") || benchSelected(cfg, "convert")))
+    {
+        backend.reset(createBackend(cfg));
+        if (!backend)
+        {
+            logMessage(LOG_ERROR, "config", "Unknown backend '" + cfg.backend() + "'!");
+            finishLog();
+            return EXIT_FAILURE;
+        }
+        if (!backend->start(cfg))
+        {
+            finishLog();
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Read the surfaces of the first body of the input file through the backend, or of the mock backend
+    if (benchSelected(cfg, "extract_surface"))
+    {
+        bool extracted;
+        if (backend)
+            extracted = benchExtractSurface(cfg, *backend, fileName, out);
+        else
+        {
+            MockBackend mock;
+            extracted = mock.start(cfg) && benchExtractSurface(cfg, mock, "", out);
+            mock.stop(cfg);
+        }
+        if (!extracted)
+            logMessage(LOG_ERROR, "bench", "Cannot read the surfaces for benchmark 'extract_surface'!");
+        retVal = extracted && retVal;
+    }
+
+    // Finalize the trim curves in place in the unit parametric domain
+    if (benchSelected(cfg, "extract_trims"))
+    {
+        const double paramOffset[2] = { 0.0, 0.0 };
+        const double paramLength[2] = { 1.0, 1.0 };
+        std::vector<Surface> data(surfaces);
+
+        retVal = runBenchmark(cfg, "extract_trims", out, [&](BenchResult &r) {
+            for (std::size_t j = 0; j < data.size(); j++)
+            {
+                for (std::size_t lid = 0; lid < data[j].trims.size(); lid++)
+                {
+                    std::vector<TrimCurve> &curves = data[j].trims[lid].curves;
+                    for (std::size_t ce = 0; ce < curves.size(); ce++)
+                        extractTrimCurveData(curves[ce], cfg, paramOffset, paramLength);
+                }
+            }
+            r.faces += (long long)data.size();
+            return true;
+        }) && retVal;
+    }
+
+    // Convert the surfaces of a body into a geomdl JSON document as written by 'json' output format
+    if (benchSelected(cfg, "serialize_json"))
+    {
+        Shape shape;
+        shape.surfaces = surfaces;
+        Json::StreamWriterBuilder wbuilder;
+        wbuilder["indentation"] = "\t";
+
+        retVal = runBenchmark(cfg, "serialize_json", out, [&](BenchResult &r) {
+            Json::Value root;
+            serializeShape(shape, root);
+            std::string jsonDocument = Json::writeString(wbuilder, root);
+            r.faces += (long long)shape.surfaces.size();
+            r.bytes += (long long)jsonDocument.size();
+            return true;
+        }) && retVal;
+    }
+
+    // Convert the file with the configured backend and output format
+    if (backend && benchSelected(cfg, "convert"))
+    {
+        retVal = runBenchmark(cfg, "convert", out, [&](BenchResult &r) {
+            Statistics stats;
+            std::vector<std::string> outputs;
+            if (!convertFile(*backend, fileName, cfg, stats, outputs))
+                return false;
+            r.faces += stats.faces;
+            r.bytes += fileSizes(outputs);
+            return true;
+        }) && retVal;
+    }
+
+    // Stop the backend
+    if (backend)
+        backend->stop(cfg);
+
+    // Write the buffered log messages
+    finishLog();
+
+    return retVal ? EXIT_SUCCESS : EXIT_FAILURE;
+}
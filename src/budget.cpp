@@ -0,0 +1,88 @@
+/*
+Copyright (c) 2019, Integrated Design and Engineering Analysis Laboratory (IDEA Lab) at Iowa State University.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "budget.h"
+
+
+// Deadlines of the conversion time budgets (the clock epoch means no deadline)
+static std::chrono::steady_clock::time_point fileDeadline;
+static std::chrono::steady_clock::time_point faceDeadline;
+
+// Compute the deadline after the given seconds (zero or negative: no deadline)
+static std::chrono::steady_clock::time_point deadlineAfter(double seconds)
+{
+    if (seconds <= 0.0)
+        return std::chrono::steady_clock::time_point();
+    return std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds));
+}
+
+static bool expired(const std::chrono::steady_clock::time_point &deadline)
+{
+    return deadline != std::chrono::steady_clock::time_point() && std::chrono::steady_clock::now() >= deadline;
+}
+
+// Start the time budget of the file, which covers reading and all bodies
+void beginFileBudget(double seconds)
+{
+    fileDeadline = deadlineAfter(seconds);
+    faceDeadline = fileDeadline;
+}
+
+// Start the time budget of a face (or a face level operation), limited by the time budget of the file
+void beginFaceBudget(double seconds)
+{
+    faceDeadline = deadlineAfter(seconds);
+    if (faceDeadline == std::chrono::steady_clock::time_point() || (fileDeadline != std::chrono::steady_clock::time_point() && fileDeadline < faceDeadline))
+        faceDeadline = fileDeadline;
+}
+
+// Return to the time budget of the file
+void endFaceBudget()
+{
+    faceDeadline = fileDeadline;
+}
+
+FaceBudgetScope::FaceBudgetScope(double seconds)
+{
+    beginFaceBudget(seconds);
+}
+
+FaceBudgetScope::~FaceBudgetScope()
+{
+    endFaceBudget();
+}
+
+// Check if the running operation is out of time, e.g. from the progress callbacks of the geometry kernel
+bool budgetExpired()
+{
+    return expired(faceDeadline);
+}
+
+bool fileBudgetExpired()
+{
+    return expired(fileDeadline);
+}
@@ -26,6 +26,16 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "common.h"
+#include "log.h"
+
+#include <iomanip>
+
+#ifdef _MSC_VER
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#endif
 
 
 const char* Config::acis_license()
@@ -74,6 +84,206 @@ bool Config::bspline()
     return bool(std::atoi(params.at("bspline").first.c_str()));
 }
 
+std::string Config::bodies()
+{
+    return params.at("bodies").first;
+}
+
+std::string Config::faces()
+{
+    return params.at("faces").first;
+}
+
+std::string Config::face_name()
+{
+    return params.at("face_name").first;
+}
+
+std::string Config::surface_type()
+{
+    return params.at("surface_type").first;
+}
+
+bool Config::release()
+{
+    return bool(std::atoi(params.at("release").first.c_str()));
+}
+
+bool Config::history()
+{
+    return bool(std::atoi(params.at("history").first.c_str()));
+}
+
+double Config::memory_baseline()
+{
+    return std::atof(params.at("memory_baseline").first.c_str());
+}
+
+bool Config::memory_compare()
+{
+    return bool(std::atoi(params.at("memory_compare").first.c_str()));
+}
+
+bool Config::stats()
+{
+    return bool(std::atoi(params.at("stats").first.c_str()));
+}
+
+bool Config::batch()
+{
+    return bool(std::atoi(params.at("batch").first.c_str()));
+}
+
+std::string Config::journal()
+{
+    return params.at("journal").first;
+}
+
+bool Config::resume()
+{
+    return bool(std::atoi(params.at("resume").first.c_str()));
+}
+
+int Config::workers()
+{
+    return std::atoi(params.at("workers").first.c_str());
+}
+
+int Config::fork()
+{
+    return std::atoi(params.at("fork").first.c_str());
+}
+
+int Config::worker()
+{
+    return std::atoi(params.at("worker").first.c_str());
+}
+
+double Config::face_timeout()
+{
+    return std::atof(params.at("face_timeout").first.c_str());
+}
+
+double Config::file_timeout()
+{
+    return std::atof(params.at("file_timeout").first.c_str());
+}
+
+double Config::fit_tolerance()
+{
+    return std::atof(params.at("fit_tolerance").first.c_str());
+}
+
+std::string Config::backend()
+{
+    return params.at("backend").first;
+}
+
+double Config::progress()
+{
+    return std::atof(params.at("progress").first.c_str());
+}
+
+std::string Config::progress_file()
+{
+    return params.at("progress_file").first;
+}
+
+int Config::mock_bodies()
+{
+    return std::atoi(params.at("mock_bodies").first.c_str());
+}
+
+int Config::mock_faces()
+{
+    return std::atoi(params.at("mock_faces").first.c_str());
+}
+
+int Config::mock_size()
+{
+    return std::atoi(params.at("mock_size").first.c_str());
+}
+
+int Config::mock_degree()
+{
+    return std::atoi(params.at("mock_degree").first.c_str());
+}
+
+int Config::mock_loops()
+{
+    return std::atoi(params.at("mock_loops").first.c_str());
+}
+
+int Config::mock_coedges()
+{
+    return std::atoi(params.at("mock_coedges").first.c_str());
+}
+
+int Config::mock_seed()
+{
+    return std::atoi(params.at("mock_seed").first.c_str());
+}
+
+int Config::mock_delay()
+{
+    return std::atoi(params.at("mock_delay").first.c_str());
+}
+
+double Config::mock_failures()
+{
+    return std::atof(params.at("mock_failures").first.c_str());
+}
+
+std::string Config::output_format()
+{
+    return params.at("output_format").first;
+}
+
+std::string Config::log_level()
+{
+    return params.at("log_level").first;
+}
+
+std::string Config::log_format()
+{
+    return params.at("log_format").first;
+}
+
+std::string Config::log_file()
+{
+    return params.at("log_file").first;
+}
+
+int Config::log_limit()
+{
+    return std::atoi(params.at("log_limit").first.c_str());
+}
+
+bool Config::log_async()
+{
+    return bool(std::atoi(params.at("log_async").first.c_str()));
+}
+
+bool Config::perf()
+{
+    return bool(std::atoi(params.at("perf").first.c_str()));
+}
+
+int Config::api_stats()
+{
+    return std::atoi(params.at("api_stats").first.c_str());
+}
+
+int Config::slow_faces()
+{
+    return std::atoi(params.at("slow_faces").first.c_str());
+}
+
+std::string Config::trace()
+{
+    return params.at("trace").first;
+}
+
 // Read license file
 std::string readLicenseFile(std::string &fileName, bool clean)
 {
@@ -131,10 +341,11 @@ void updateConfig(std::string &key, std::string &value, Config &cfg)
     if (search != cfg.params.end())
     {
         std::string val;
-        std::transform(value.begin(), value.end(), value.begin(), ::tolower);
-        if (value == "false" || value == "0")
+        std::string lvalue(value);
+        std::transform(lvalue.begin(), lvalue.end(), lvalue.begin(), ::tolower);
+        if (lvalue == "false" || lvalue == "0")
             val = "0";
-        else if (value == "true" || value == "0")
+        else if (lvalue == "true" || lvalue == "1")
             val = "1";
         else
             val = std::string(value);
@@ -142,135 +353,86 @@ void updateConfig(std::string &key, std::string &value, Config &cfg)
     }
 }
 
-// Unlock ACIS
-bool unlockACIS(Config &cfg)
+// Get current and peak resident memory of the process (in bytes)
+bool getMemoryUsage(std::size_t &current, std::size_t &peak)
 {
-    spa_unlock_result out = spa_unlock_products(cfg.acis_license());
-
-    bool retVal = true;
-    switch (out.get_state())
+    current = 0;
+    peak = 0;
+#ifdef _MSC_VER
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return false;
+    current = pmc.WorkingSetSize;
+    peak = pmc.PeakWorkingSetSize;
+    return true;
+#else
+    // VmRSS and VmHWM fields are in kB
+    std::ifstream fileRead("/proc/self/status");
+    if (!fileRead)
+        return false;
+    std::string line;
+    while (std::getline(fileRead, line))
     {
-    case SPA_UNLOCK_PASS_WARN:
-        if (cfg.acis_warnings())
-            std::cout << "[LICENSE WARNING] " << out.get_message_text() << std::endl;
-        break;
-    case SPA_UNLOCK_FAIL:
-        std::cout << "[LICENSE ERROR] " << out.get_message_text() << std::endl;
-        retVal = false;
-        break;
-    default:
-        /* License is valid -- SPA_UNLOCK_PASS */;
+        if (line.compare(0, 6, "VmRSS:") == 0)
+            current = std::strtoul(line.substr(6).c_str(), NULL, 10) * 1024;
+        else if (line.compare(0, 6, "VmHWM:") == 0)
+            peak = std::strtoul(line.substr(6).c_str(), NULL, 10) * 1024;
     }
-
-    return retVal;
+    return true;
+#endif
 }
 
-// Check ACIS API outcome
-void checkOutcome(const outcome &res, const char *apiCall, int lineNumber, Config &cfg)
+// Print current and peak resident memory of the process
+void printMemoryUsage(const std::string &label)
 {
-    // Check if ACIS has encountered any errors (fail-safe or critical)
-    if (res.encountered_errors())
-    {
-        // Query for ACIS error number
-        err_mess_type err_no = res.error_number();
-
-        // Get error message
-        std::string error_str = std::string(find_err_mess(err_no)) + " (" + std::string(find_err_ident(err_no)) + ")";
-
-        // Flag to stop the application
-        bool stopApp = false;
-
-        // Display error information, crash program if critical
-        if (res.ok())
-        {
-            if (cfg.acis_warnings())
-                std::cout << "[ERROR] ACIS encountered a non-critical error: " << error_str << std::endl;
-        }
-        else
-        {
-            std::cout << "[ERROR] ACIS encountered a critical error: " << error_str << std::endl;
-            stopApp = true;
-        }
-
-        // Print function name and its line number
-        std::cout << "Function: " << apiCall << "; Line: " << lineNumber << std::endl;
-
-        // Stop the application in the ACIS way
-        if (stopApp)
-            sys_error(err_no);
-    }
-
-    // Print warnings
-    if (cfg.acis_warnings())
+    std::size_t current, peak;
+    if (getMemoryUsage(current, peak))
     {
-        err_mess_type *warnings;
-        int nwarn = get_warnings(warnings);
-        if (nwarn > 0)
-        {
-            std::cout << "[WARNING] ACIS produced the following warnings:" << std::endl;
-            for (int i = 0; i < nwarn; ++i)
-                std::cout << "  - " << warnings[i] << ": " << find_err_mess(warnings[i]) << std::endl;
-            // Reset number of warnings to zero
-            init_warnings();
-        }
+        std::ostringstream msg;
+        msg << label << ": current " << current / (1024 * 1024) << " MB, peak " << peak / (1024 * 1024) << " MB";
+        logMessage(LOG_INFO, "memory", msg.str());
     }
-
 }
 
-// Read ACIS file
-bool readSatFile(std::string &fileName, ENTITY_LIST &readList, Config &cfg)
+// Print the difference of the peak resident memory of the process and the peak memory of a baseline run (in MB)
+void printMemorySaving(double baselineMB)
 {
-    // Try to open SAT file for reading
-    FILE *fp = fopen(fileName.c_str(), "r");
-    if (fp == NULL)
-    {
-        std::cerr << "[ERROR] Cannot open file '" << fileName << "' for reading!" << std::endl;
-        return false;
-    }
-
-    // Initialize a variable to store ACIS API outcome
-    outcome res;
-
-    // Read the SAT file into an ENTITY_LIST
-    res = api_restore_entity_list(fp, TRUE, readList);
-    checkOutcome(res, "api_restore_entity_list", __LINE__, cfg);
-
-    // Close file
-    fclose(fp);
-
-    return true;
+    std::size_t current, peak;
+    if (baselineMB <= 0.0 || !getMemoryUsage(current, peak))
+        return;
+    double peakMB = double(peak) / (1024 * 1024);
+    double saved = baselineMB - peakMB;
+    std::ostringstream msg;
+    msg << std::fixed << std::setprecision(1) << "Peak memory " << peakMB << " MB against the baseline of " << baselineMB << " MB: "
+        << std::fabs(saved) << " MB (" << 100.0 * std::fabs(saved) / baselineMB << "%) " << ((saved >= 0.0) ? "saved" : "more");
+    logMessage(LOG_INFO, "memory", msg.str());
 }
 
-// Save ACIS file
-bool saveSatFile(ENTITY_LIST &saveList, std::string &fileName, Config &cfg)
+// Print conversion statistics
+void printStatistics(Statistics &stats)
 {
-    // Create FileInfo object
-    FileInfo info;
-    info.set_product_id(fileName.c_str());
-    info.set_units(1.0);  // millimeters
-    api_set_file_info(FileUnits | FileIdent, info);
-    api_save_version(18, 0); // compatibility with the older versions
-
-    // Set line numbers on
-    api_set_int_option("sequence_save_files", 1);
-
-    // Open file
-    FILE *fp = fopen(fileName.c_str(), "w");
-    if (fp == NULL)
-    {
-        std::cerr << "[ERROR] Cannot open file '" << fileName << "' for writing!" << std::endl;
-        return false;
-    }
-    
-    // Initialize a variable to store ACIS API outcome
-    outcome res;
-
-    // Save SAT file
-    res = api_save_entity_list(fp, true, saveList);
-    checkOutcome(res, "api_save_entity_list", __LINE__, cfg);
-
-    // Close file
-    fclose(fp);
+    std::cout << "Conversion statistics:" << std::endl;
+    std::cout << "  - Bodies processed: " << stats.bodies << std::endl;
+    std::cout << "  - Faces extracted: " << stats.faces << std::endl;
+    std::cout << "  - Faces added by splitting periodic faces: " << stats.facesSplit << std::endl;
+    std::cout << "  - Surface control points: " << stats.surfCtrlpts << std::endl;
+    std::cout << "  - Trim curve control points: " << stats.trimCtrlpts << std::endl;
+    std::cout << "  - Bodies failed: " << stats.bodiesFailed << std::endl;
+    std::cout << "  - Faces failed: " << stats.facesFailed << std::endl;
+    std::cout << "  - Bodies skipped on timeout: " << stats.bodiesTimedOut << std::endl;
+    std::cout << "  - Faces skipped on timeout: " << stats.facesTimedOut << std::endl;
+}
 
-    return true;
+// Add the statistics of a file to the total statistics
+void addStatistics(Statistics &total, const Statistics &stats)
+{
+    total.bodies += stats.bodies;
+    total.faces += stats.faces;
+    total.facesSplit += stats.facesSplit;
+    total.surfCtrlpts += stats.surfCtrlpts;
+    total.trimCtrlpts += stats.trimCtrlpts;
+    total.bodiesFailed += stats.bodiesFailed;
+    total.facesFailed += stats.facesFailed;
+    total.bodiesTimedOut += stats.bodiesTimedOut;
+    total.facesTimedOut += stats.facesTimedOut;
 }
@@ -38,11 +38,16 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <exception>
 #include <cstddef>
 #include <cstdio>
+#include <cstdlib>
 #include <cmath>
 
-// External libraries
-#include "ACIS.h"
 
+// Default geometry kernel backend
+#ifdef RWSAT_WITH_ACIS
+#define RWSAT_DEFAULT_BACKEND "acis"
+#else
+#define RWSAT_DEFAULT_BACKEND "mock"
+#endif
 
 // Application configuration
 struct Config {
@@ -57,7 +62,47 @@ struct Config {
         { "trims", { "1", "Extract trim curves" } },
         { "sense", { "1", "Extract surface and trim curve direction w.r.t. the face" } },
         { "transform", { "0", "Apply transforms" } },
-        { "bspline", { "1", "Convert the underlying geometry to B-Spline" } }
+        { "bspline", { "1", "Convert the underlying geometry to B-Spline" } },
+        { "bodies", { "", "Indices of the bodies to process, e.g. 0,2-4 (empty: all bodies)" } },
+        { "faces", { "", "Indices of the faces to process in each body, e.g. 0-9,12 (empty: all faces)" } },
+        { "face_name", { "", "Process only the faces carrying a named attribute (ATTRIB_GEN_NAME) with this name" } },
+        { "surface_type", { "", "Process only the faces with these surface types: plane,cone,sphere,torus,spline" } },
+        { "release", { "0", "Delete each body after its data is written and report memory usage" } },
+        { "history", { "1", "Record ACIS history (disable to save memory and time in batch conversions)" } },
+        { "memory_baseline", { "0", "Peak memory in MB of a history=1 run of the same input on this machine, the memory saved by this run is reported against it (0: not reported)" } },
+        { "memory_compare", { "0", "Convert the file with history in a child process first and report the memory saved by this run against its peak memory" } },
+        { "stats", { "0", "Prints the conversion statistics" } },
+        { "batch", { "0", "Treat FILENAME as a manifest listing the input files, one file per line" } },
+        { "journal", { "", "Journal of the processed files in batch mode (empty: manifest file name + .journal)" } },
+        { "resume", { "0", "Skip the files completed in the journal of the previous batch run" } },
+        { "workers", { "0", "Number of worker processes converting the files in batch mode (0: convert in this process)" } },
+        { "fork", { "0", "Number of child processes extracting the bodies of the loaded model (0: extract in this process)" } },
+        { "worker", { "0", "Run as a worker process of the batch driver writing the results to this file descriptor (internal)" } },
+        { "face_timeout", { "0", "Time budget of each face in seconds, the face is skipped when it is exceeded (0: unlimited)" } },
+        { "file_timeout", { "0", "Time budget of the file in seconds, the remaining faces are skipped when it is exceeded (0: unlimited)" } },
+        { "fit_tolerance", { "0", "Fit tolerance of the spline approximations, a looser tolerance fits the approximated surfaces again with fewer control points, e.g. 1e-3 (0: ACIS default)" } },
+        { "backend", { RWSAT_DEFAULT_BACKEND, "Geometry kernel backend: acis or mock (synthetic in-memory models)" } },
+        { "progress", { "0", "Interval of the progress reports in seconds (0: no progress reports)" } },
+        { "progress_file", { "", "Write the progress reports to this status file as JSON (empty: standard error)" } },
+        { "mock_bodies", { "4", "Number of bodies generated by the mock backend" } },
+        { "mock_faces", { "16", "Number of faces per body generated by the mock backend" } },
+        { "mock_size", { "8", "Number of control points in each parametric direction of the mock surfaces" } },
+        { "mock_degree", { "3", "Degree of the mock surfaces" } },
+        { "mock_loops", { "2", "Number of trim loops (1 periphery and the rest holes) per mock face" } },
+        { "mock_coedges", { "4", "Number of trim curves per mock trim loop" } },
+        { "mock_seed", { "1", "Random seed of the mock backend" } },
+        { "mock_delay", { "0", "Time spent converting each mock face in milliseconds" } },
+        { "mock_failures", { "0", "Fraction of the mock faces failing to convert or extract, e.g. 0.1" } },
+        { "output_format", { "json", "Output format: json (geomdl), json_stream (geomdl, streamed while extracting) or none" } },
+        { "log_level", { "info", "Minimum level of the logged messages: debug, info, success, warning or error" } },
+        { "log_format", { "text", "Log format: text or jsonl (one JSON object per line)" } },
+        { "log_file", { "", "Write the log messages to this file (empty: standard output)" } },
+        { "log_limit", { "0", "Maximum number of logged debug, info and warning messages of each type (0: unlimited)" } },
+        { "log_async", { "0", "Write the log messages from a background thread" } },
+        { "perf", { "0", "Record the time and the hardware performance counters (Linux) of the conversion phases and bodies" } },
+        { "api_stats", { "0", "Print the count, total and maximum latency of the ACIS API calls with the largest total latency, e.g. 10 (0: disabled)" } },
+        { "slow_faces", { "0", "Print the slowest faces with their processing time by stage, e.g. 20, and a histogram of the face processing times (0: disabled)" } },
+        { "trace", { "", "Write the timeline of the files, bodies, faces, ACIS API calls and writer operations to this file (Chrome trace event JSON)" } }
     };
 
     // Methods
@@ -70,15 +115,69 @@ struct Config {
     bool sense();
     bool transform();
     bool bspline();
+    std::string bodies();
+    std::string faces();
+    std::string face_name();
+    std::string surface_type();
+    bool release();
+    bool history();
+    double memory_baseline();
+    bool memory_compare();
+    bool stats();
+    bool batch();
+    std::string journal();
+    bool resume();
+    int workers();
+    int fork();
+    int worker();
+    double face_timeout();
+    double file_timeout();
+    double fit_tolerance();
+    std::string backend();
+    double progress();
+    std::string progress_file();
+    int mock_bodies();
+    int mock_faces();
+    int mock_size();
+    int mock_degree();
+    int mock_loops();
+    int mock_coedges();
+    int mock_seed();
+    int mock_delay();
+    double mock_failures();
+    std::string output_format();
+    std::string log_level();
+    std::string log_format();
+    std::string log_file();
+    int log_limit();
+    bool log_async();
+    bool perf();
+    int api_stats();
+    int slow_faces();
+    std::string trace();
+};
+
+// Conversion statistics
+struct Statistics {
+    int bodies = 0;
+    int faces = 0;
+    int facesSplit = 0;
+    long long surfCtrlpts = 0;
+    long long trimCtrlpts = 0;
+    int bodiesFailed = 0;
+    int facesFailed = 0;
+    int bodiesTimedOut = 0;
+    int facesTimedOut = 0;
 };
 
 // Function prototypes
 std::string readLicenseFile(std::string &, bool = true);
 void parseConfig(char *, Config &);
 void updateConfig(std::string &, std::string &, Config &);
-void checkOutcome(const outcome&, const char*, int, Config &);
-bool unlockACIS(Config &cfg);
-bool saveSatFile(ENTITY_LIST &, std::string &, Config &);
-bool readSatFile(std::string &, ENTITY_LIST &, Config &);
+bool getMemoryUsage(std::size_t &, std::size_t &);
+void printMemoryUsage(const std::string &);
+void printMemorySaving(double);
+void printStatistics(Statistics &);
+void addStatistics(Statistics &, const Statistics &);
 
 #endif /* COMMON_H */
@@ -0,0 +1,233 @@
+/*
+Copyright (c) 2019, Integrated Design and Engineering Analysis Laboratory (IDEA Lab) at Iowa State University.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "common_acis.h"
+
+
+// Unlock ACIS
+bool unlockACIS(Config &cfg)
+{
+    spa_unlock_result out = spa_unlock_products(cfg.acis_license());
+
+    bool retVal = true;
+    switch (out.get_state())
+    {
+    case SPA_UNLOCK_PASS_WARN:
+        if (cfg.acis_warnings())
+            logMessage(LOG_WARNING, "license", std::string("License: ") + out.get_message_text());
+        break;
+    case SPA_UNLOCK_FAIL:
+        logMessage(LOG_ERROR, "license", std::string("License: ") + out.get_message_text());
+        retVal = false;
+        break;
+    default:
+        /* License is valid -- SPA_UNLOCK_PASS */;
+    }
+
+    return retVal;
+}
+
+// Check ACIS API outcome, returns false if ACIS encountered a critical error
+bool checkOutcome(const outcome &res, const char *apiCall, int lineNumber, Config &cfg)
+{
+    bool retVal = true;
+
+    // Check if ACIS has encountered any errors (fail-safe or critical)
+    if (res.encountered_errors())
+    {
+        // Query for ACIS error number
+        err_mess_type err_no = res.error_number();
+
+        // Get error message with the function name and its line number
+        std::ostringstream error_str;
+        error_str << find_err_mess(err_no) << " (" << find_err_ident(err_no) << "); Function: " << apiCall << "; Line: " << lineNumber;
+
+        // Display error information
+        if (res.ok())
+        {
+            if (cfg.acis_warnings())
+                logMessage(LOG_ERROR, "acis_error", "ACIS encountered a non-critical error: " + error_str.str());
+        }
+        else
+        {
+            logMessage(LOG_ERROR, "acis_error", "ACIS encountered a critical error: " + error_str.str());
+            retVal = false;
+        }
+    }
+
+    // Print warnings
+    if (cfg.acis_warnings())
+    {
+        err_mess_type *warnings;
+        int nwarn = get_warnings(warnings);
+        if (nwarn > 0)
+        {
+            for (int i = 0; i < nwarn; ++i)
+            {
+                std::ostringstream msg;
+                msg << "ACIS produced a warning: " << warnings[i] << ": " << find_err_mess(warnings[i]) << "; Function: " << apiCall;
+                logMessage(LOG_WARNING, "acis_warning", msg.str());
+            }
+            // Reset number of warnings to zero
+            init_warnings();
+        }
+    }
+
+    return retVal;
+}
+
+// Check ACIS API outcome and raise the error in the ACIS way if it is critical
+// (use only inside API_BEGIN/API_NOP_BEGIN blocks, which catch the error and contain the failure)
+void requireOutcome(const outcome &res, const char *apiCall, int lineNumber, Config &cfg)
+{
+    if (!checkOutcome(res, apiCall, lineNumber, cfg))
+        sys_error(res.error_number());
+}
+
+// Read ACIS file
+bool readSatFile(std::string &fileName, ENTITY_LIST &readList, Config &cfg)
+{
+    // Try to open SAT file for reading
+    FILE *fp = fopen(fileName.c_str(), "r");
+    if (fp == NULL)
+    {
+        logMessage(LOG_ERROR, "file", "Cannot open file '" + fileName + "' for reading!");
+        return false;
+    }
+
+    // Initialize a variable to store ACIS API outcome
+    outcome res;
+
+    // Read the SAT file into an ENTITY_LIST
+    {
+        ApiScope api("api_restore_entity_list");
+        res = api_restore_entity_list(fp, TRUE, readList);
+    }
+    bool retVal = checkOutcome(res, "api_restore_entity_list", __LINE__, cfg);
+
+    // Close file
+    fclose(fp);
+
+    return retVal;
+}
+
+// Save ACIS file
+bool saveSatFile(ENTITY_LIST &saveList, std::string &fileName, Config &cfg)
+{
+    // Create FileInfo object
+    FileInfo info;
+    info.set_product_id(fileName.c_str());
+    info.set_units(1.0);  // millimeters
+    api_set_file_info(FileUnits | FileIdent, info);
+    api_save_version(18, 0); // compatibility with the older versions
+
+    // Set line numbers on
+    api_set_int_option("sequence_save_files", 1);
+
+    // Open file
+    FILE *fp = fopen(fileName.c_str(), "w");
+    if (fp == NULL)
+    {
+        logMessage(LOG_ERROR, "file", "Cannot open file '" + fileName + "' for writing!");
+        return false;
+    }
+    
+    // Initialize a variable to store ACIS API outcome
+    outcome res;
+
+    // Save SAT file
+    {
+        ApiScope api("api_save_entity_list");
+        res = api_save_entity_list(fp, true, saveList);
+    }
+    bool retVal = checkOutcome(res, "api_save_entity_list", __LINE__, cfg);
+
+    // Close file
+    fclose(fp);
+
+    return retVal;
+}
+
+// Split only the periodic and closed faces of the body, returns the number of faces added by splitting
+// (a face which cannot be split is left as it is)
+int splitPeriodicFaces(BODY *body, Config &cfg)
+{
+    // Initialize a variable to store ACIS API outcome
+    outcome res;
+
+    // Get the face list
+    ENTITY_LIST face_list;
+    {
+        ApiScope api("api_get_faces");
+        res = api_get_faces(body, face_list);
+    }
+    if (!checkOutcome(res, "api_get_faces", __LINE__, cfg))
+        return 0;
+
+    // Find the faces which need splitting before calling the splitting API
+    ENTITY_LIST split_list;
+    int face_count = face_list.iteration_count();
+    for (int j = 0; j < face_count; j++)
+    {
+        FACE *f = (FACE *)face_list[j];
+        const surface &surf = f->geometry()->equation();
+        if (surf.periodic_u() || surf.periodic_v() || surf.closed_u() || surf.closed_v())
+            split_list.add(f);
+    }
+
+    // Split the faces, one by one
+    int split_count = split_list.iteration_count();
+    if (split_count > 0)
+    {
+        res = api_set_int_option("new_periodic_splitting", 1);
+        checkOutcome(res, "api_set_int_option", __LINE__, cfg);
+    }
+    for (int j = 0; j < split_count && !fileBudgetExpired(); j++)
+    {
+        // Splitting is interrupted by the progress callback when the time budget of the face is exceeded
+        FaceBudgetScope faceBudget(cfg.face_timeout());
+        {
+            ApiScope api("api_split_periodic_faces");
+            res = api_split_periodic_faces(split_list[j]);
+        }
+        if (!checkOutcome(res, "api_split_periodic_faces", __LINE__, cfg) && budgetExpired())
+            logMessage(LOG_WARNING, "split_timeout", "Time budget is exceeded while splitting a periodic face, the face is not split");
+    }
+    if (split_count == 0)
+        return 0;
+
+    // A successful call does not mean that the face was split, compare the face counts instead
+    ENTITY_LIST split_faces;
+    {
+        ApiScope api("api_get_faces");
+        res = api_get_faces(body, split_faces);
+    }
+    if (!checkOutcome(res, "api_get_faces", __LINE__, cfg))
+        return 0;
+
+    return split_faces.iteration_count() - face_count;
+}
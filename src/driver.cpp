@@ -0,0 +1,518 @@
+/*
+Copyright (c) 2019, Integrated Design and Engineering Analysis Laboratory (IDEA Lab) at Iowa State University.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "driver.h"
+#include "rwsat.h"
+
+#include <memory>
+#include <algorithm>
+
+#ifndef _MSC_VER
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#endif
+
+
+#ifndef _MSC_VER
+// Write the whole string to the file descriptor
+static bool writeAll(int fd, const std::string &str)
+{
+    std::size_t done = 0;
+    while (done < str.size())
+    {
+        ssize_t n = write(fd, str.data() + done, str.size() - done);
+        if (n < 0)
+            return false;
+        done += n;
+    }
+    return true;
+}
+#endif
+
+// Worker mode: convert the files read from the standard input with the started backend and write
+// a JSON line for each file to the result file descriptor
+bool runWorker(Backend &backend, int resultFd, Config &cfg, Statistics &stats)
+{
+#ifdef _MSC_VER
+    logMessage(LOG_ERROR, "config", "Worker processes are not supported on this platform!");
+    return false;
+#else
+    Json::StreamWriterBuilder wbuilder;
+    wbuilder["indentation"] = "";
+
+    std::string input;
+    while (std::getline(std::cin, input))
+    {
+        JournalEntry e;
+        resetPerf();
+        convertJob(backend, input, cfg, e);
+        addStatistics(stats, e.stats);
+
+        // Write the log messages and the trace events of the file before reporting the result
+        flushLog();
+        flushTrace();
+
+        // Report the performance data of the file with the result, the driver merges it into its reports
+        Json::Value entryDef;
+        serializeJournalEntry(e, entryDef);
+        serializePerf(entryDef["perf"]);
+        if (!writeAll(resultFd, Json::writeString(wbuilder, entryDef) + "\n"))
+            return false;
+    }
+    return true;
+#endif
+}
+
+#ifndef _MSC_VER
+// Worker process and its pipes
+struct Worker {
+    pid_t pid = -1;
+    int jobFd = -1;
+    int resultFd = -1;
+    std::string buffer;
+    std::string job;
+};
+
+// Result file descriptor of the worker processes
+static const int workerResultFd = 3;
+
+// Start a worker process running the executable in worker mode
+static bool spawnWorker(const std::string &exe, const std::string &options, Worker &w)
+{
+    int jobPipe[2], resultPipe[2];
+    if (pipe(jobPipe) != 0)
+        return false;
+    if (pipe(resultPipe) != 0)
+    {
+        close(jobPipe[0]);
+        close(jobPipe[1]);
+        return false;
+    }
+
+    // Other workers should not inherit the pipes
+    for (int fd : { jobPipe[0], jobPipe[1], resultPipe[0], resultPipe[1] })
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        for (int fd : { jobPipe[0], jobPipe[1], resultPipe[0], resultPipe[1] })
+            close(fd);
+        return false;
+    }
+
+    if (pid == 0)
+    {
+        // Read the jobs from the standard input and write the results to the result file descriptor
+        // (dup2 clears the close-on-exec flag of the new descriptors)
+        dup2(jobPipe[0], STDIN_FILENO);
+        dup2(resultPipe[1], workerResultFd);
+        std::string workerOptions = options + ";batch=0;workers=0;stats=0;show_config=0;progress=0;worker=" + std::to_string(workerResultFd);
+        std::vector<char *> args = { const_cast<char *>(exe.c_str()), const_cast<char *>("-"), const_cast<char *>(workerOptions.c_str()), NULL };
+        execvp(exe.c_str(), args.data());
+        _exit(127);
+    }
+
+    close(jobPipe[0]);
+    close(resultPipe[1]);
+    w = Worker();
+    w.pid = pid;
+    w.jobFd = jobPipe[1];
+    w.resultFd = resultPipe[0];
+    return true;
+}
+
+// Close the job pipe of the worker, the worker exits after finishing its job
+static void stopWorker(Worker &w)
+{
+    if (w.jobFd >= 0)
+        close(w.jobFd);
+    w.jobFd = -1;
+}
+
+// Wait for the worker to exit
+static void reapWorker(Worker &w)
+{
+    stopWorker(w);
+    if (w.resultFd >= 0)
+        close(w.resultFd);
+    w.resultFd = -1;
+    if (w.pid > 0)
+    {
+        int status;
+        waitpid(w.pid, &status, 0);
+    }
+    w.pid = -1;
+}
+
+// Get the file size for the scheduling (largest files first)
+static long long fileSize(const std::string &fileName)
+{
+    struct stat st;
+    if (stat(fileName.c_str(), &st) != 0)
+        return 0;
+    return (long long)st.st_size;
+}
+#endif
+
+// Convert the input files listed in the manifest with worker processes, the files are handed out one by one
+// to the idle workers starting with the largest file, the results are recorded in the journal
+bool runWorkers(const std::string &exe, const std::string &manifestName, const std::string &options, Config &cfg, Statistics &stats)
+{
+#ifdef _MSC_VER
+    logMessage(LOG_ERROR, "config", "Worker processes are not supported on this platform!");
+    return false;
+#else
+    // Read the input file names
+    std::vector<std::string> inputs;
+    if (!readManifest(manifestName, inputs))
+        return false;
+
+    // Read the journal of the interrupted run or start a new one
+    Journal journal(cfg.journal().empty() ? manifestName + ".journal" : cfg.journal());
+    if (!journal.open(cfg.resume()))
+        return false;
+
+    // Collect the remaining files, the largest files are converted first
+    std::vector< std::pair<long long, std::string> > jobs;
+    for (std::size_t i = 0; i < inputs.size(); i++)
+    {
+        if (!(cfg.resume() && journal.completed(inputs[i])))
+            jobs.push_back(std::make_pair(fileSize(inputs[i]), inputs[i]));
+    }
+    std::stable_sort(jobs.begin(), jobs.end(), [](const std::pair<long long, std::string> &a, const std::pair<long long, std::string> &b) { return a.first > b.first; });
+    if (jobs.size() < inputs.size())
+        logMessage(LOG_INFO, "batch", std::to_string(inputs.size() - jobs.size()) + " files were processed by the previous runs and skipped");
+
+    // The workers may exit while a job is written
+    signal(SIGPIPE, SIG_IGN);
+
+    bool retVal = true;
+    std::size_t nextJob = 0;
+    std::size_t jobsDone = 0;
+
+    // Hand out the next job to the worker or stop the worker if all jobs are handed out
+    auto dispatch = [&](Worker &w) {
+        w.job.clear();
+        if (nextJob >= jobs.size())
+        {
+            stopWorker(w);
+            return;
+        }
+        w.job = jobs[nextJob++].second;
+        journal.entry(w.job).status = "started";
+        journal.append(journal.entry(w.job));
+        if (!writeAll(w.jobFd, w.job + "\n"))
+        {
+            // The worker cannot take the job, it is handed out again
+            nextJob--;
+            w.job.clear();
+            reapWorker(w);
+        }
+    };
+
+    // The workers are started in the loop below and restarted when they exit
+    int numWorkers = int(std::min<std::size_t>(std::max(cfg.workers(), 1), jobs.size()));
+    std::vector<Worker> workers(numWorkers);
+
+    Json::CharReaderBuilder rbuilder;
+    std::unique_ptr<Json::CharReader> reader(rbuilder.newCharReader());
+    while (jobsDone < jobs.size())
+    {
+        // Restart the exited workers while jobs remain, e.g. a worker which could not take its job
+        for (int k = 0; k < numWorkers && nextJob < jobs.size(); k++)
+        {
+            if (workers[k].pid > 0)
+                continue;
+            if (!spawnWorker(exe, options, workers[k]))
+            {
+                logMessage(LOG_ERROR, "worker", "Cannot start a worker process!");
+                retVal = false;
+                continue;
+            }
+            dispatch(workers[k]);
+        }
+
+        // Wait for the results of the running workers
+        std::vector<pollfd> fds;
+        std::vector<int> fdWorkers;
+        for (int k = 0; k < numWorkers; k++)
+        {
+            if (workers[k].resultFd >= 0)
+            {
+                pollfd p = { workers[k].resultFd, POLLIN, 0 };
+                fds.push_back(p);
+                fdWorkers.push_back(k);
+            }
+        }
+        if (fds.empty())
+        {
+            // No worker can be started for the remaining jobs
+            if (nextJob < jobs.size())
+                return false;
+            continue;
+        }
+        int ready;
+        {
+            PhaseScope waitPhase(PHASE_WAIT);
+            ready = poll(fds.data(), fds.size(), -1);
+        }
+        if (ready < 0)
+            continue;
+
+        for (std::size_t f = 0; f < fds.size(); f++)
+        {
+            if (fds[f].revents == 0)
+                continue;
+            Worker &w = workers[fdWorkers[f]];
+
+            char buf[4096];
+            ssize_t n = read(w.resultFd, buf, sizeof(buf));
+            if (n <= 0)
+            {
+                // The worker exited, its job is recorded as crashed and a new worker is started for the remaining jobs
+                reapWorker(w);
+                if (!w.job.empty())
+                {
+                    logMessage(LOG_ERROR, "worker", "Worker process crashed while converting file '" + w.job + "'");
+                    JournalEntry &e = journal.entry(w.job);
+                    e.status = "crashed";
+                    journal.append(e);
+                    w.job.clear();
+                    jobsDone++;
+                    retVal = false;
+                    progressFilesDone(int(jobsDone), int(jobs.size()), stats);
+                }
+                continue;
+            }
+
+            // Process the complete result lines
+            w.buffer.append(buf, n);
+            std::size_t eol;
+            while ((eol = w.buffer.find('\n')) != std::string::npos)
+            {
+                std::string line = w.buffer.substr(0, eol);
+                w.buffer.erase(0, eol + 1);
+
+                Json::Value entryDef;
+                std::string errs;
+                if (!reader->parse(line.data(), line.data() + line.size(), &entryDef, &errs))
+                    continue;
+                JournalEntry result;
+                deserializeJournalEntry(entryDef, result);
+                mergePerf(entryDef["perf"]);
+                journal.entry(result.input) = result;
+                journal.append(result);
+                addStatistics(stats, result.stats);
+                if (result.status != "done")
+                    retVal = false;
+                jobsDone++;
+                progressFilesDone(int(jobsDone), int(jobs.size()), stats);
+                dispatch(w);
+            }
+        }
+    }
+
+    // Wait for the workers to exit
+    for (int k = 0; k < numWorkers; k++)
+        reapWorker(workers[k]);
+
+    return retVal;
+#endif
+}
+
+// Extract the bodies of the loaded model in child processes, each child shares the loaded model with the parent
+// (copy-on-write) and extracts the bodies with index % fork == child index
+bool forkBodies(Backend &backend, Config &cfg, Filter &filter, Statistics &stats, Sink &sink, std::vector<std::string> &outputs)
+{
+#ifdef _MSC_VER
+    logMessage(LOG_WARNING, "config", "Child processes are not supported on this platform, the bodies are extracted in this process");
+    bool retVal = extractBodies(backend, cfg, filter, stats, sink, 0, 1);
+    outputs = sink.outputFiles();
+    return retVal;
+#else
+    // The children should not repeat the buffered log messages and trace events, and should not inherit the
+    // background log writer (only the forking thread exists in the child)
+    suspendLog();
+    flushTrace();
+
+    int numChildren = cfg.fork();
+    std::vector<pid_t> pids;
+    std::vector<int> resultFds;
+    bool retVal = true;
+    for (int k = 0; k < numChildren; k++)
+    {
+        int resultPipe[2];
+        if (pipe(resultPipe) != 0)
+        {
+            logMessage(LOG_ERROR, "fork", "Cannot create a pipe for a child process!");
+            retVal = false;
+            break;
+        }
+
+        pid_t pid = fork();
+        if (pid < 0)
+        {
+            logMessage(LOG_ERROR, "fork", "Cannot start a child process!");
+            close(resultPipe[0]);
+            close(resultPipe[1]);
+            retVal = false;
+            break;
+        }
+
+        if (pid == 0)
+        {
+            // Extract the bodies of the child and report the result to the parent
+            close(resultPipe[0]);
+            for (std::size_t c = 0; c < resultFds.size(); c++)
+                close(resultFds[c]);
+            restartPerf(cfg);
+            JournalEntry e;
+            bool extracted = extractBodies(backend, cfg, filter, e.stats, sink, k, numChildren);
+            e.status = extracted ? "done" : "failed";
+            e.outputs = sink.outputFiles();
+
+            Json::Value entryDef;
+            serializeJournalEntry(e, entryDef);
+            serializePerf(entryDef["perf"]);
+            Json::StreamWriterBuilder wbuilder;
+            wbuilder["indentation"] = "";
+            writeAll(resultPipe[1], Json::writeString(wbuilder, entryDef) + "\n");
+            close(resultPipe[1]);
+
+            // Skip the destructors and the exit handlers of the parent state
+            flushLog();
+            flushTrace();
+            _exit(extracted ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+
+        close(resultPipe[1]);
+        pids.push_back(pid);
+        resultFds.push_back(resultPipe[0]);
+    }
+    resumeLog();
+
+    // Collect the results of the children
+    PhaseScope waitPhase(PHASE_WAIT);
+    Json::CharReaderBuilder rbuilder;
+    std::unique_ptr<Json::CharReader> reader(rbuilder.newCharReader());
+    for (std::size_t c = 0; c < pids.size(); c++)
+    {
+        std::string result;
+        char buf[4096];
+        ssize_t n;
+        while ((n = read(resultFds[c], buf, sizeof(buf))) > 0)
+            result.append(buf, n);
+        close(resultFds[c]);
+
+        int status = 0;
+        waitpid(pids[c], &status, 0);
+
+        Json::Value entryDef;
+        std::string errs;
+        if (!reader->parse(result.data(), result.data() + result.size(), &entryDef, &errs))
+        {
+            logMessage(LOG_ERROR, "fork", "Child process #" + std::to_string(c) + " exited without reporting its result");
+            retVal = false;
+            continue;
+        }
+        JournalEntry e;
+        deserializeJournalEntry(entryDef, e);
+        addStatistics(stats, e.stats);
+        mergePerf(entryDef["perf"]);
+        outputs.insert(outputs.end(), e.outputs.begin(), e.outputs.end());
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+            retVal = false;
+    }
+
+    return retVal;
+#endif
+}
+
+// Convert the file with history in a child process and return the peak resident memory of the child in MB, which is
+// the baseline of the memory saved by disabling history on the same input and machine (0: not measured)
+double measureHistoryPeak(const std::string &fileName, Config &cfg)
+{
+#ifdef _MSC_VER
+    logMessage(LOG_WARNING, "config", "Child processes are not supported on this platform, the memory baseline is not measured");
+    return 0.0;
+#else
+    // The child should not repeat the buffered log messages and trace events
+    suspendLog();
+    flushTrace();
+
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        // Convert quietly, only the errors are logged
+        Config baselineCfg(cfg);
+        baselineCfg.params["history"].first = "1";
+        baselineCfg.params["log_level"].first = "error";
+        baselineCfg.params["progress"].first = "0";
+        configureLog(baselineCfg);
+        configureProgress(baselineCfg);
+
+        bool converted = false;
+        std::unique_ptr<Backend> backend(createBackend(baselineCfg));
+        if (backend && backend->start(baselineCfg))
+        {
+            Statistics stats;
+            std::vector<std::string> outputs;
+            converted = convertFile(*backend, fileName, baselineCfg, stats, outputs);
+            backend->stop(baselineCfg);
+        }
+
+        // Skip the destructors and the exit handlers of the parent state
+        flushLog();
+        _exit(converted ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+    resumeLog();
+    if (pid < 0)
+    {
+        logMessage(LOG_ERROR, "memory", "Cannot start a child process for the memory baseline!");
+        return 0.0;
+    }
+
+    // The maximum resident set size of the child is reported in kilobytes on Linux
+    int status = 0;
+    struct rusage usage;
+    if (wait4(pid, &status, 0, &usage) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+    {
+        logMessage(LOG_WARNING, "memory", "Conversion with history failed, the memory baseline is not measured");
+        return 0.0;
+    }
+    double peakMB = double(usage.ru_maxrss) / 1024.0;
+    logMessage(LOG_INFO, "memory", "Peak memory of the conversion with history: " + std::to_string(int(peakMB)) + " MB");
+    return peakMB;
+#endif
+}
@@ -29,10 +29,12 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define EXTRACT_H
 
 #include "common.h"
-#include "json/json.h"
+#include "shape.h"
+#include "transform.h"
 
 
-void extractSurfaceData(bs3_surface &, Config &, Json::Value &);
-void extractTrimCurveData(bs2_curve &, Config &, double *, double *, Json::Value &);
+// Function prototypes
+int extractSurfaceData(Surface &, Config &, const double * = NULL);
+int extractTrimCurveData(TrimCurve &, Config &, const double *, const double *);
 
 #endif /* EXTRACT_H */
@@ -0,0 +1,182 @@
+/*
+Copyright (c) 2019, Integrated Design and Engineering Analysis Laboratory (IDEA Lab) at Iowa State University.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "filter.h"
+#include "log.h"
+
+#include <cctype>
+#include <cerrno>
+#include <climits>
+
+
+Filter::Filter(Config &cfg) : valid(true)
+{
+    if (!parseIndexRanges(cfg.bodies(), bodyRanges))
+    {
+        logMessage(LOG_ERROR, "config", "Invalid body indices '" + cfg.bodies() + "' in the filter!");
+        valid = false;
+    }
+    if (!parseIndexRanges(cfg.faces(), faceRanges))
+    {
+        logMessage(LOG_ERROR, "config", "Invalid face indices '" + cfg.faces() + "' in the filter!");
+        valid = false;
+    }
+    faceName = cfg.face_name();
+
+    // Convert surface type names to surface types
+    std::string types = cfg.surface_type();
+    std::stringstream ss(types);
+    std::string typeName;
+    while (std::getline(ss, typeName, ','))
+    {
+        int typeId = surfaceTypeId(typeName);
+        if (typeId >= 0)
+            surfaceTypes.push_back(SurfaceType(typeId));
+        else
+        {
+            // An empty type list selects all faces, a misspelled type must not disable the filter
+            logMessage(LOG_ERROR, "config", "Unknown surface type '" + typeName + "' in the filter!");
+            valid = false;
+        }
+    }
+}
+
+// Check if the body should be processed
+bool Filter::selectBody(int bodyIdx)
+{
+    return bodyRanges.empty() || inIndexRanges(bodyIdx, bodyRanges);
+}
+
+// Check if the face should be processed (call before converting the face geometry)
+bool Filter::selectFace(Backend &backend, int faceIdx)
+{
+    // Face index filter
+    if (!faceRanges.empty() && !inIndexRanges(faceIdx, faceRanges))
+        return false;
+
+    // Surface type filter
+    if (!surfaceTypes.empty())
+    {
+        SurfaceType faceType = backend.surfaceType(faceIdx);
+        if (std::find(surfaceTypes.begin(), surfaceTypes.end(), faceType) == surfaceTypes.end())
+            return false;
+    }
+
+    // Named attribute filter
+    if (!faceName.empty() && !backend.hasNamedAttribute(faceIdx, faceName))
+        return false;
+
+    return true;
+}
+
+// Parse a non-negative index, returns false if the string is not a complete number
+static bool parseIndex(const std::string &str, int &idx)
+{
+    if (str.empty() || !std::isdigit((unsigned char)str[0]))
+        return false;
+    char *end;
+    errno = 0;
+    long value = std::strtol(str.c_str(), &end, 10);
+    if (*end != '\0' || errno == ERANGE || value > INT_MAX)
+        return false;
+    idx = int(value);
+    return true;
+}
+
+// Parse index ranges from a string, e.g. "0,2-4,7", returns false if a range is invalid
+bool parseIndexRanges(const std::string &rangeStr, std::vector< std::pair<int, int> > &ranges)
+{
+    std::stringstream ss(rangeStr);
+    std::string token;
+    while (std::getline(ss, token, ','))
+    {
+        if (token.empty())
+            continue;
+        std::size_t pos = token.find('-');
+        int idxStart, idxEnd;
+        if (pos == std::string::npos)
+        {
+            if (!parseIndex(token, idxStart))
+                return false;
+            idxEnd = idxStart;
+        }
+        else
+        {
+            if (!parseIndex(token.substr(0, pos), idxStart) || !parseIndex(token.substr(pos + 1), idxEnd) || idxStart > idxEnd)
+                return false;
+        }
+        ranges.push_back(std::make_pair(idxStart, idxEnd));
+    }
+    return true;
+}
+
+// Check if the index is in any of the ranges
+bool inIndexRanges(int idx, const std::vector< std::pair<int, int> > &ranges)
+{
+    for (auto r : ranges)
+    {
+        if (idx >= r.first && idx <= r.second)
+            return true;
+    }
+    return false;
+}
+
+// Find the surface type of the surface type name, returns -1 if the name is unknown
+int surfaceTypeId(const std::string &typeName)
+{
+    if (typeName == "plane")
+        return SURFACE_PLANE;
+    if (typeName == "cone")
+        return SURFACE_CONE;
+    if (typeName == "sphere")
+        return SURFACE_SPHERE;
+    if (typeName == "torus")
+        return SURFACE_TORUS;
+    if (typeName == "spline")
+        return SURFACE_SPLINE;
+    return -1;
+}
+
+// Find the surface type name of the surface type (the inverse of surfaceTypeId)
+const char *surfaceTypeName(int typeId)
+{
+    switch (typeId)
+    {
+    case SURFACE_PLANE:
+        return "plane";
+    case SURFACE_CONE:
+        return "cone";
+    case SURFACE_SPHERE:
+        return "sphere";
+    case SURFACE_TORUS:
+        return "torus";
+    case SURFACE_SPLINE:
+        return "spline";
+    default:
+        return "other";
+    }
+}
@@ -0,0 +1,59 @@
+/*
+Copyright (c) 2019, Integrated Design and Engineering Analysis Laboratory (IDEA Lab) at Iowa State University.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef FILTER_H
+#define FILTER_H
+
+#include <vector>
+#include <utility>
+
+#include "common.h"
+#include "backend.h"
+
+
+// Body and face selection filters
+struct Filter {
+    // Filter parameters
+    std::vector< std::pair<int, int> > bodyRanges;
+    std::vector< std::pair<int, int> > faceRanges;
+    std::string faceName;
+    std::vector<SurfaceType> surfaceTypes;
+    bool valid;
+
+    // Methods
+    explicit Filter(Config &);
+    bool selectBody(int);
+    bool selectFace(Backend &, int);
+};
+
+// Function prototypes
+bool parseIndexRanges(const std::string &, std::vector< std::pair<int, int> > &);
+bool inIndexRanges(int, const std::vector< std::pair<int, int> > &);
+int surfaceTypeId(const std::string &);
+const char *surfaceTypeName(int);
+
+#endif /* FILTER_H */
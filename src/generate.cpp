@@ -0,0 +1,900 @@
+/*
+Copyright (c) 2019, Integrated Design and Engineering Analysis Laboratory (IDEA Lab) at Iowa State University.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "generate.h"
+
+#include <fstream>
+#include <sstream>
+#include <map>
+
+#include "json/json.h"
+
+
+GenConfig::GenConfig()
+{
+    params.insert({
+        { "gen_mode", { "sample", "Generated model: sample (4 sample bodies), corpus (parametrized bodies), pattern (copies of the seed bodies) or stress (pathological bodies)" } },
+        { "gen_bodies", { "4", "Number of bodies in the corpus" } },
+        { "gen_faces", { "6", "Number of faces per body in the corpus" } },
+        { "gen_spline_ratio", { "0.5", "Fraction of the spline faces in the corpus, the others are plane, cone, sphere and torus faces" } },
+        { "gen_degree", { "3", "Degree of the spline faces" } },
+        { "gen_size", { "8", "Number of control points in each parametric direction of the spline faces" } },
+        { "gen_holes", { "0", "Number of holes (inner trim loops) in each plane and spline face" } },
+        { "gen_seed", { "1", "Random seed of the generator" } },
+        { "gen_pattern", { "10,10,1", "Number of the copies of the seed bodies along x, y and z axes in the pattern" } },
+        { "gen_pattern_spacing", { "", "Distance between the copies along x, y and z axes (default: 1.25 times the size of the seed bodies)" } },
+        { "gen_pattern_rotate", { "0", "Rotation of each copy relative to the previous one about z-axis in degrees" } },
+        { "gen_pattern_seed", { "", "Seed bodies of the pattern as a .SAT file (default: the bodies generated by corpus mode)" } },
+        { "gen_unite", { "0", "Unite the copies of each seed body into one body" } },
+        { "gen_stress_cases", { "", "Stress cases to generate, e.g. 'sliver,degree' (default: all of periodic, apex, pole, sliver, tiny, degree and coedges)" } },
+        { "gen_stress_degree", { "11", "Maximum degree of the high degree spline faces in the stress cases" } },
+        { "gen_stress_edges", { "1000", "Maximum number of edges in the loop of the many coedges stress case" } },
+        { "gen_truth", { "", "Write the ground truth of the generated model (counts, surface types, boxes, sample points) to this JSON file" } },
+        { "gen_samples", { "3", "Number of sample points in each parametric direction of the faces in the ground truth" } }
+    });
+}
+
+std::string GenConfig::gen_mode()
+{
+    return params.at("gen_mode").first;
+}
+
+int GenConfig::gen_bodies()
+{
+    return std::atoi(params.at("gen_bodies").first.c_str());
+}
+
+int GenConfig::gen_faces()
+{
+    return std::atoi(params.at("gen_faces").first.c_str());
+}
+
+double GenConfig::gen_spline_ratio()
+{
+    return std::atof(params.at("gen_spline_ratio").first.c_str());
+}
+
+int GenConfig::gen_degree()
+{
+    return std::atoi(params.at("gen_degree").first.c_str());
+}
+
+int GenConfig::gen_size()
+{
+    return std::atoi(params.at("gen_size").first.c_str());
+}
+
+int GenConfig::gen_holes()
+{
+    return std::atoi(params.at("gen_holes").first.c_str());
+}
+
+int GenConfig::gen_seed()
+{
+    return std::atoi(params.at("gen_seed").first.c_str());
+}
+
+std::string GenConfig::gen_pattern()
+{
+    return params.at("gen_pattern").first;
+}
+
+std::string GenConfig::gen_pattern_spacing()
+{
+    return params.at("gen_pattern_spacing").first;
+}
+
+double GenConfig::gen_pattern_rotate()
+{
+    return std::atof(params.at("gen_pattern_rotate").first.c_str());
+}
+
+std::string GenConfig::gen_pattern_seed()
+{
+    return params.at("gen_pattern_seed").first;
+}
+
+bool GenConfig::gen_unite()
+{
+    return bool(std::atoi(params.at("gen_unite").first.c_str()));
+}
+
+std::string GenConfig::gen_stress_cases()
+{
+    return params.at("gen_stress_cases").first;
+}
+
+int GenConfig::gen_stress_degree()
+{
+    return std::atoi(params.at("gen_stress_degree").first.c_str());
+}
+
+int GenConfig::gen_stress_edges()
+{
+    return std::atoi(params.at("gen_stress_edges").first.c_str());
+}
+
+std::string GenConfig::gen_truth()
+{
+    return params.at("gen_truth").first;
+}
+
+int GenConfig::gen_samples()
+{
+    return std::atoi(params.at("gen_samples").first.c_str());
+}
+
+// Move the body to the position and make the transformation a part of its geometry
+static bool placeBody(BODY *body, const SPAtransf &transf, Config &cfg)
+{
+    outcome res = api_apply_transf(body, transf);
+    if (!checkOutcome(res, "api_apply_transf", __LINE__, cfg))
+        return false;
+    res = api_change_body_trans(body, NULL);
+    return checkOutcome(res, "api_change_body_trans", __LINE__, cfg);
+}
+
+// Generate the sample bodies: a cuboid, a torus, a toroidal sheet and a sphere
+bool generateSample(GenConfig &cfg, ENTITY_LIST &saveList)
+{
+    // Initialize a variable to store ACIS API outcome
+    outcome res;
+
+    // Create a cuboid
+    BODY *cuboid;
+    res = api_make_cuboid(5, 10, 20, cuboid);
+    if (!checkOutcome(res, "api_make_cuboid", __LINE__, cfg))
+        return false;
+
+    // Create transformation
+    SPAposition rotate_pos(20, 0, 0);
+    SPAtransf r = rotate_transf(M_PI / 4, SPAvector(0, 0, 1));
+    SPAvector to_rotate_pos = rotate_pos - SPAposition(0, 0, 0);
+    SPAtransf t = translate_transf(to_rotate_pos);
+    SPAtransf tc = t.inverse() * r * t;
+
+    // Transform cuboid
+    if (!placeBody(cuboid, tc, cfg))
+        return false;
+
+    // Add to save list
+    saveList.add(cuboid);
+
+    // Create a torus
+    BODY *torus;
+    res = api_make_torus(25, 12.5, torus);
+    if (!checkOutcome(res, "api_make_torus", __LINE__, cfg))
+        return false;
+
+    // Create transformation
+    SPAposition translate_pos1(0, 0, -100);
+    SPAvector to_translate_pos1 = translate_pos1 - SPAposition(0, 0, 0);
+    SPAtransf tt1 = translate_transf(to_translate_pos1);
+
+    // Transform torus
+    if (!placeBody(torus, tt1, cfg))
+        return false;
+
+    // Add to save list
+    saveList.add(torus);
+
+    // Create a toroidal face
+    FACE *torodialFace;
+    SPAposition center(25, 25, 25);
+    SPAvector normal(0, 0, 1);
+    res = api_face_torus(center, 10, 2.5, 0, 360, 0, 180, &normal, torodialFace);
+    if (!checkOutcome(res, "api_face_torus", __LINE__, cfg))
+        return false;
+
+    // Create a sheet body from the toroidal face
+    FACE *faces[1];
+    faces[0] = torodialFace;
+    BODY *torus2;
+    res = api_sheet_from_ff(1, faces, torus2);
+    if (!checkOutcome(res, "api_sheet_from_ff", __LINE__, cfg))
+        return false;
+
+    // Create transformation
+    SPAposition translate_pos2(0, 0, -100);
+    SPAvector to_translate_pos2 = translate_pos2 - SPAposition(0, 0, 0);
+    SPAtransf tt2 = translate_transf(to_translate_pos1);
+
+    // Transform toroidal sheet body
+    if (!placeBody(torus2, tt2, cfg))
+        return false;
+
+    // Add to save list
+    saveList.add(torus2);
+
+    // Make a sphere
+    BODY *sphere;
+    res = api_make_sphere(2.5, sphere);
+    if (!checkOutcome(res, "api_make_sphere", __LINE__, cfg))
+        return false;
+
+    // Create transformation
+    SPAposition translate_pos3(100, 100, 0);
+    SPAvector to_translate_pos3 = translate_pos3 - SPAposition(0, 0, 0);
+    SPAtransf ts = translate_transf(to_translate_pos3);
+
+    // Transform sphere
+    if (!placeBody(sphere, ts, cfg))
+        return false;
+
+    // Add to save list
+    saveList.add(sphere);
+
+    return true;
+}
+
+// Make an analytic face in the cell starting at the corner (type: 0 plane, 1 cone, 2 sphere, 3 torus)
+static FACE *makeAnalyticFace(int type, const SPAposition &corner, double size, Config &cfg)
+{
+    outcome res;
+    FACE *face = NULL;
+    SPAvector normal(0, 0, 1);
+    SPAposition center(corner.x() + size / 2, corner.y() + size / 2, corner.z());
+    switch (type)
+    {
+    case 0:
+        res = api_face_plane(corner, size, size, &normal, face);
+        checkOutcome(res, "api_face_plane", __LINE__, cfg);
+        break;
+    case 1:
+        res = api_face_cylinder_cone(center, SPAvector(0, 0, size / 2), size / 3, size / 4, 0, 270, 1.0, NULL, face);
+        checkOutcome(res, "api_face_cylinder_cone", __LINE__, cfg);
+        break;
+    case 2:
+        res = api_face_sphere(center, size / 3, 0, 270, -45, 45, &normal, face);
+        checkOutcome(res, "api_face_sphere", __LINE__, cfg);
+        break;
+    default:
+        res = api_face_torus(center, size / 3, size / 8, 0, 270, 0, 180, &normal, face);
+        checkOutcome(res, "api_face_torus", __LINE__, cfg);
+    }
+    return res.ok() ? face : NULL;
+}
+
+// Make a non-rational spline face with a random control net over the cell starting at the corner
+// If pole is set, the first row of the control points is collapsed into a point (a degenerate edge)
+static FACE *makeSplineFace(std::mt19937 &gen, const SPAposition &corner, double sizeU, double sizeV, int degree, int numCtrlpts, bool pole, Config &cfg)
+{
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+    // Control points on a grid with random heights, v index changes fastest
+    std::vector<SPAposition> ctrlpts;
+    ctrlpts.reserve(numCtrlpts * numCtrlpts);
+    double height = 0.1 * std::min(sizeU, sizeV);
+    for (int i = 0; i < numCtrlpts; i++)
+    {
+        for (int j = 0; j < numCtrlpts; j++)
+        {
+            double x = corner.x() + sizeU * i / (numCtrlpts - 1);
+            double y = corner.y() + sizeV * j / (numCtrlpts - 1);
+            if (pole && i == 0)
+                ctrlpts.push_back(SPAposition(x, corner.y() + sizeV / 2, corner.z()));
+            else
+                ctrlpts.push_back(SPAposition(x, y, corner.z() + height * dist(gen)));
+        }
+    }
+
+    // Clamped uniform knot vector in ACIS form (the end knots are repeated degree times)
+    std::vector<double> knots;
+    for (int k = 0; k < degree; k++)
+        knots.push_back(0.0);
+    int numSpans = numCtrlpts - degree;
+    for (int k = 1; k < numSpans; k++)
+        knots.push_back(double(k) / numSpans);
+    for (int k = 0; k < degree; k++)
+        knots.push_back(1.0);
+
+    FACE *face = NULL;
+    outcome res = api_mk_fa_spl_ctrlpts(degree, FALSE, 0, 0, numCtrlpts, degree, FALSE, 0, 0, numCtrlpts,
+        ctrlpts.data(), NULL, SPAresabs, int(knots.size()), knots.data(), int(knots.size()), knots.data(), SPAresabs, face);
+    return checkOutcome(res, "api_mk_fa_spl_ctrlpts", __LINE__, cfg) ? face : NULL;
+}
+
+// Punch holes through the face in the cell starting at the corner, each hole adds an inner trim loop
+static bool makeHoles(BODY *body, const SPAposition &corner, double size, int numHoles, Config &cfg)
+{
+    double radius = size / (4.0 * (numHoles + 1));
+    for (int k = 0; k < numHoles; k++)
+    {
+        BODY *tool;
+        outcome res = api_make_frustum(2.0 * size, radius, radius, radius, tool);
+        if (!checkOutcome(res, "api_make_frustum", __LINE__, cfg))
+            return false;
+        SPAvector offset(corner.x() + size * (k + 1) / (numHoles + 1), corner.y() + size / 2, corner.z());
+        if (!placeBody(tool, translate_transf(offset), cfg))
+            return false;
+        res = api_subtract(tool, body);
+        if (!checkOutcome(res, "api_subtract", __LINE__, cfg))
+            return false;
+    }
+    return true;
+}
+
+// Generate a corpus of sheet bodies with a mix of analytic and spline faces laid out on a grid
+bool generateCorpus(GenConfig &cfg, ENTITY_LIST &saveList)
+{
+    int numBodies = std::max(cfg.gen_bodies(), 0);
+    int numFaces = std::max(cfg.gen_faces(), 1);
+    int degree = std::max(cfg.gen_degree(), 1);
+    int numCtrlpts = std::max(cfg.gen_size(), degree + 1);
+    int numHoles = std::max(cfg.gen_holes(), 0);
+
+    // Faces are laid out on a square grid of cells
+    const double cellSize = 10.0;
+    const double spacing = 12.0;
+    int columns = int(std::ceil(std::sqrt(double(numFaces))));
+
+    for (int i = 0; i < numBodies; i++)
+    {
+        // Each body has its own random sequence, the same body is generated for the same seed
+        std::seed_seq seq = { (unsigned int)cfg.gen_seed(), (unsigned int)i };
+        std::mt19937 gen(seq);
+        std::uniform_real_distribution<double> dist(0.0, 1.0);
+
+        std::vector<FACE *> faces(numFaces, NULL);
+        std::vector<bool> holeFaces(numFaces, false);
+        int analyticCount = 0;
+        for (int j = 0; j < numFaces; j++)
+        {
+            SPAposition corner(spacing * (j % columns), spacing * (j / columns), 0.0);
+            if (dist(gen) < cfg.gen_spline_ratio())
+            {
+                faces[j] = makeSplineFace(gen, corner, cellSize, cellSize, degree, numCtrlpts, false, cfg);
+                holeFaces[j] = true;
+            }
+            else
+            {
+                int type = analyticCount++ % 4;
+                faces[j] = makeAnalyticFace(type, corner, cellSize, cfg);
+                holeFaces[j] = (type == 0);
+            }
+            if (faces[j] == NULL)
+                return false;
+        }
+
+        // Create a sheet body from the faces
+        BODY *body;
+        outcome res = api_sheet_from_ff(numFaces, faces.data(), body);
+        if (!checkOutcome(res, "api_sheet_from_ff", __LINE__, cfg))
+            return false;
+
+        // Add the holes to the plane and spline faces
+        for (int j = 0; j < numFaces && numHoles > 0; j++)
+        {
+            SPAposition corner(spacing * (j % columns), spacing * (j / columns), 0.0);
+            if (holeFaces[j] && !makeHoles(body, corner, cellSize, numHoles, cfg))
+                return false;
+        }
+
+        // Stack the bodies along z-axis
+        if (!placeBody(body, translate_transf(SPAvector(0, 0, 2.0 * cellSize * i)), cfg))
+            return false;
+
+        saveList.add(body);
+    }
+
+    return true;
+}
+
+// Stress cases of the pathological geometry
+static const char *stressCaseNames[] = { "periodic", "apex", "pole", "sliver", "tiny", "degree", "coedges" };
+static const int stressCaseCount = 7;
+
+// Make a sheet body from a single face
+static BODY *makeSheet(FACE *face, Config &cfg)
+{
+    if (face == NULL)
+        return NULL;
+    BODY *body = NULL;
+    outcome res = api_sheet_from_ff(1, &face, body);
+    return checkOutcome(res, "api_sheet_from_ff", __LINE__, cfg) ? body : NULL;
+}
+
+// Make a planar sheet body bounded by a star shaped polygon with the given number of edges
+static BODY *makePolygonSheet(std::mt19937 &gen, int numEdges, double size, Config &cfg)
+{
+    std::uniform_real_distribution<double> dist(0.5, 1.0);
+    std::vector<SPAposition> pts;
+    pts.reserve(numEdges + 1);
+    for (int k = 0; k < numEdges; k++)
+    {
+        double angle = 2.0 * M_PI * k / numEdges;
+        double radius = size * dist(gen);
+        pts.push_back(SPAposition(radius * std::cos(angle), radius * std::sin(angle), 0.0));
+    }
+    pts.push_back(pts[0]);
+
+    BODY *body = NULL;
+    outcome res = api_make_wire(NULL, int(pts.size()), pts.data(), body);
+    if (!checkOutcome(res, "api_make_wire", __LINE__, cfg))
+        return NULL;
+    ENTITY_LIST faces;
+    res = api_cover_wires(body, plane(SPAposition(0, 0, 0), SPAunit_vector(0, 0, 1)), faces);
+    return checkOutcome(res, "api_cover_wires", __LINE__, cfg) ? body : NULL;
+}
+
+// Make a body of the stress case
+static BODY *makeStressBody(int stressCase, std::mt19937 &gen, GenConfig &cfg)
+{
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+    double size = 5.0 + 10.0 * dist(gen);
+    SPAposition origin(0, 0, 0);
+    SPAvector normal(0, 0, 1);
+    BODY *body = NULL;
+    outcome res;
+    switch (stressCase)
+    {
+    case 0:
+    {
+        // Closed solids with the periodic faces to be split and the poles of the sphere
+        int shape = int(3 * dist(gen));
+        if (shape == 0)
+        {
+            res = api_make_sphere(size, body);
+            checkOutcome(res, "api_make_sphere", __LINE__, cfg);
+        }
+        else if (shape == 1)
+        {
+            res = api_make_torus(size, size * (0.1 + 0.8 * dist(gen)), body);
+            checkOutcome(res, "api_make_torus", __LINE__, cfg);
+        }
+        else
+        {
+            res = api_make_frustum(2.0 * size, size, size, size, body);
+            checkOutcome(res, "api_make_frustum", __LINE__, cfg);
+        }
+        break;
+    }
+    case 1:
+        // Cone with an apex (a degenerate edge)
+        res = api_make_frustum(2.0 * size, size, size, 0.0, body);
+        checkOutcome(res, "api_make_frustum", __LINE__, cfg);
+        break;
+    case 2:
+        // Spline face with a collapsed edge (a pole)
+        body = makeSheet(makeSplineFace(gen, origin, size, size, 3, 6, true, cfg), cfg);
+        break;
+    case 3:
+    {
+        // Sliver faces, the width is a tiny fraction of the length
+        double width = size * std::pow(10.0, -3.0 - 2.0 * dist(gen));
+        if (dist(gen) < 0.5)
+        {
+            FACE *face = NULL;
+            res = api_face_plane(origin, size, width, &normal, face);
+            if (checkOutcome(res, "api_face_plane", __LINE__, cfg))
+                body = makeSheet(face, cfg);
+        }
+        else
+            body = makeSheet(makeSplineFace(gen, origin, size, width, 3, 6, false, cfg), cfg);
+        break;
+    }
+    case 4:
+    {
+        // Tiny faces close to the modeling tolerance
+        double tiny = SPAresabs * (10.0 + 100.0 * dist(gen));
+        FACE *face = NULL;
+        res = api_face_plane(origin, tiny, tiny, &normal, face);
+        if (checkOutcome(res, "api_face_plane", __LINE__, cfg))
+            body = makeSheet(face, cfg);
+        break;
+    }
+    case 5:
+    {
+        // High degree spline faces with a dense control net
+        int maxDegree = std::max(cfg.gen_stress_degree(), 1);
+        int minDegree = std::max(maxDegree / 2, 1);
+        int degree = minDegree + int((maxDegree - minDegree + 1) * dist(gen)) % (maxDegree - minDegree + 1);
+        int numCtrlpts = degree + 1 + int((degree + 1) * dist(gen));
+        body = makeSheet(makeSplineFace(gen, origin, size, size, degree, numCtrlpts, false, cfg), cfg);
+        break;
+    }
+    default:
+    {
+        // A loop with thousands of coedges
+        int maxEdges = std::max(cfg.gen_stress_edges(), 3);
+        int minEdges = std::max(maxEdges / 2, 3);
+        int numEdges = minEdges + int((maxEdges - minEdges + 1) * dist(gen)) % (maxEdges - minEdges + 1);
+        body = makePolygonSheet(gen, numEdges, size, cfg);
+    }
+    }
+    return body;
+}
+
+// Generate a corpus of the pathological bodies, the bodies cycle through the selected stress cases
+// The faces are named after the stress case, e.g. 'stress_sliver', for selecting them with 'face_name' option of sat2json
+bool generateStress(GenConfig &cfg, ENTITY_LIST &saveList)
+{
+    // Find the selected stress cases
+    std::vector<int> cases;
+    std::stringstream ss(cfg.gen_stress_cases());
+    std::string token;
+    while (std::getline(ss, token, ','))
+    {
+        if (token.empty())
+            continue;
+        int stressCase = -1;
+        for (int k = 0; k < stressCaseCount; k++)
+        {
+            if (token == stressCaseNames[k])
+                stressCase = k;
+        }
+        if (stressCase < 0)
+        {
+            logMessage(LOG_ERROR, "config", "Unknown stress case '" + token + "'!");
+            return false;
+        }
+        cases.push_back(stressCase);
+    }
+    if (cases.empty())
+    {
+        for (int k = 0; k < stressCaseCount; k++)
+            cases.push_back(k);
+    }
+
+    int numBodies = std::max(cfg.gen_bodies(), 0);
+    for (int i = 0; i < numBodies; i++)
+    {
+        // Each body has its own random sequence, the same body is generated for the same seed
+        std::seed_seq seq = { (unsigned int)cfg.gen_seed(), (unsigned int)i };
+        std::mt19937 gen(seq);
+
+        int stressCase = cases[i % cases.size()];
+        BODY *body = makeStressBody(stressCase, gen, cfg);
+        if (body == NULL)
+            return false;
+
+        // Name the faces after the stress case
+        ENTITY_LIST faces;
+        outcome res = api_get_faces(body, faces);
+        if (!checkOutcome(res, "api_get_faces", __LINE__, cfg))
+            return false;
+        std::string name = std::string("stress_") + stressCaseNames[stressCase];
+        for (int j = 0; j < faces.iteration_count(); j++)
+        {
+            res = api_add_generic_named_attribute(faces[j], name.c_str(), i);
+            if (!checkOutcome(res, "api_add_generic_named_attribute", __LINE__, cfg))
+                return false;
+        }
+
+        // Place the bodies along x-axis
+        if (!placeBody(body, translate_transf(SPAvector(40.0 * i, 0, 0)), cfg))
+            return false;
+
+        saveList.add(body);
+    }
+
+    return true;
+}
+
+// Parse the values along x, y and z axes from a string, e.g. "10,10,1", returns the number of values parsed
+static int parseAxisValues(const std::string &valueStr, double values[3])
+{
+    std::stringstream ss(valueStr);
+    std::string token;
+    int count = 0;
+    while (count < 3 && std::getline(ss, token, ','))
+        values[count++] = std::atof(token.c_str());
+    return count;
+}
+
+// Generate a pattern of the seed bodies, the placement of each copy is a part of its geometry
+bool generatePattern(GenConfig &cfg, ENTITY_LIST &saveList)
+{
+    double counts[3] = { 1, 1, 1 };
+    if (parseAxisValues(cfg.gen_pattern(), counts) == 0)
+    {
+        logMessage(LOG_ERROR, "config", "Cannot parse the pattern '" + cfg.gen_pattern() + "'!");
+        return false;
+    }
+    int numCopies[3];
+    for (int c = 0; c < 3; c++)
+        numCopies[c] = std::max(int(counts[c]), 1);
+
+    // Read or generate the seed bodies
+    ENTITY_LIST seedList;
+    std::string seedFile = cfg.gen_pattern_seed();
+    if (seedFile.empty() ? !generateCorpus(cfg, seedList) : !readSatFile(seedFile, seedList, cfg))
+        return false;
+    if (seedList.iteration_count() == 0)
+    {
+        logMessage(LOG_ERROR, "config", "There are no seed bodies for the pattern!");
+        return false;
+    }
+
+    // Find the extent of the seed bodies
+    SPAbox seedBox;
+    outcome res = api_get_entity_box(seedList, NULL, seedBox);
+    if (!checkOutcome(res, "api_get_entity_box", __LINE__, cfg))
+        return false;
+    SPAposition seedLow = seedBox.low();
+    SPAposition seedHigh = seedBox.high();
+    SPAposition seedCenter(0.5 * (seedLow.x() + seedHigh.x()), 0.5 * (seedLow.y() + seedHigh.y()), 0.5 * (seedLow.z() + seedHigh.z()));
+
+    // Place the copies apart from each other by default
+    double spacing[3];
+    for (int c = 0; c < 3; c++)
+        spacing[c] = 1.25 * std::max(seedHigh.coordinate(c) - seedLow.coordinate(c), 1.0);
+    if (!cfg.gen_pattern_spacing().empty())
+        parseAxisValues(cfg.gen_pattern_spacing(), spacing);
+
+    // Rotation of the copies about z-axis through the center of the seed bodies
+    SPAtransf toCenter = translate_transf(SPAposition(0, 0, 0) - seedCenter);
+    SPAtransf fromCenter = toCenter.inverse();
+    double angle = cfg.gen_pattern_rotate() * M_PI / 180.0;
+
+    for (int i = 0; i < seedList.iteration_count(); i++)
+    {
+        BODY *seed = (BODY *)seedList[i];
+        BODY *united = NULL;
+        int copyIdx = 0;
+        for (int ix = 0; ix < numCopies[0]; ix++)
+        {
+            for (int iy = 0; iy < numCopies[1]; iy++)
+            {
+                for (int iz = 0; iz < numCopies[2]; iz++)
+                {
+                    // The seed body is the first copy, unless the copies are united with it, which would change the seed
+                    BODY *copy = seed;
+                    if (copyIdx > 0 || cfg.gen_unite())
+                    {
+                        res = api_copy_body(seed, copy);
+                        if (!checkOutcome(res, "api_copy_body", __LINE__, cfg))
+                            return false;
+                    }
+
+                    // The transformation is applied to the geometry, otherwise sat2json removes it (transform=0)
+                    // and all copies are extracted at the place of the seed body
+                    SPAtransf transf = toCenter * rotate_transf(angle * copyIdx, SPAvector(0, 0, 1)) * fromCenter
+                        * translate_transf(SPAvector(spacing[0] * ix, spacing[1] * iy, spacing[2] * iz));
+                    if (copyIdx > 0 && !placeBody(copy, transf, cfg))
+                        return false;
+                    copyIdx++;
+
+                    // Unite the copy with the previous copies, the copy is deleted by the union
+                    if (!cfg.gen_unite())
+                        saveList.add(copy);
+                    else if (united == NULL)
+                        united = copy;
+                    else
+                    {
+                        res = api_unite(copy, united);
+                        if (!checkOutcome(res, "api_unite", __LINE__, cfg))
+                            return false;
+                    }
+                }
+            }
+        }
+        if (united != NULL)
+        {
+            saveList.add(united);
+
+            // The unchanged seed body is not saved
+            res = api_del_entity(seed);
+            if (!checkOutcome(res, "api_del_entity", __LINE__, cfg))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+// Find the surface type name of the face, the names are the same as in 'surface_types' option of sat2json
+static const char *faceTypeName(FACE *face)
+{
+    SURFACE *geom = face->geometry();
+    if (geom == NULL)
+        return "other";
+
+    switch (geom->identity())
+    {
+    case PLANE_TYPE:
+        return "plane";
+    case CONE_TYPE:
+        return "cone";
+    case SPHERE_TYPE:
+        return "sphere";
+    case TORUS_TYPE:
+        return "torus";
+    case SPLINE_TYPE:
+        return "spline";
+    default:
+        return "other";
+    }
+}
+
+static void serializePoint(const SPAposition &pt, Json::Value &ptDef)
+{
+    for (int c = 0; c < 3; c++)
+        ptDef[c] = pt.coordinate(c);
+}
+
+// Find the bounding box of the entity, returns false if ACIS cannot compute the box
+static bool entityBox(ENTITY *ent, Json::Value &boxDef, SPAbox &box, Config &cfg)
+{
+    ENTITY_LIST boxList;
+    boxList.add(ent);
+    outcome res = api_get_entity_box(boxList, NULL, box);
+    if (!checkOutcome(res, "api_get_entity_box", __LINE__, cfg))
+        return false;
+    serializePoint(box.low(), boxDef["min"]);
+    serializePoint(box.high(), boxDef["max"]);
+    return true;
+}
+
+// Sample the points on a uniform grid of the surface parameters, the points outside the face are dropped
+// The sample points are transformed with the owner transformation of the face as the control points in sat2json output
+static int sampleFace(FACE *face, const SPAbox &box, int numSamples, Json::Value &samplesDef)
+{
+    samplesDef = Json::Value(Json::arrayValue);
+    SURFACE *geom = face->geometry();
+    if (geom == NULL || numSamples < 1)
+        return 0;
+
+    // The surface is in the coordinates of the body
+    const SPAtransf &bodyTransf = get_owner_transf(face);
+    const surface &surf = geom->equation();
+    SPApar_box parBox = surf.param_range(box * bodyTransf.inverse());
+    SPAinterval rangeU = parBox.u_range();
+    SPAinterval rangeV = parBox.v_range();
+    if (!rangeU.finite() || !rangeV.finite())
+        return 0;
+
+    // Sample the inside of the parameter range, the corners are usually on the boundary
+    int count = 0;
+    for (int i = 0; i < numSamples; i++)
+    {
+        double u = rangeU.start_pt() + rangeU.length() * (i + 0.5) / numSamples;
+        for (int j = 0; j < numSamples; j++)
+        {
+            double v = rangeV.start_pt() + rangeV.length() * (j + 0.5) / numSamples;
+            SPAposition pt = surf.eval_position(SPApar_pos(u, v));
+            if (point_in_face(pt, face, SPAtransf()) != point_inside_face)
+                continue;
+            Json::Value ptDef;
+            serializePoint(pt * bodyTransf, ptDef);
+            samplesDef.append(ptDef);
+            count++;
+        }
+    }
+    return count;
+}
+
+// Write the ground truth of the saved model as sat2json reads it, the faces are in the same order as in sat2json output
+bool writeGroundTruth(GenConfig &cfg, std::string &satFile)
+{
+    // Read the saved model back, the entity order may change while saving
+    ENTITY_LIST readList;
+    if (!readSatFile(satFile, readList, cfg))
+        return false;
+
+    Json::Value root;
+    root["file"] = satFile;
+    root["gen_mode"] = cfg.gen_mode();
+    root["gen_seed"] = cfg.gen_seed();
+
+    // Coordinate frame of the boxes and the sample points, the same 'transform' option should be given to sat2json
+    root["transform"] = int(cfg.transform());
+
+    bool retVal = true;
+    int numBodies = 0;
+    int numFaces = 0;
+    std::map<std::string, int> typeCounts;
+    Json::Value bodiesDef = Json::Value(Json::arrayValue);
+    for (int i = 0; i < readList.iteration_count() && retVal; i++)
+    {
+        BODY *body = (BODY *)readList[i];
+
+        // Split the periodic faces and remove the transformation as sat2json does
+        splitPeriodicFaces(body, cfg);
+        outcome res;
+        if (!cfg.transform())
+        {
+            res = api_remove_transf(body);
+            if (!checkOutcome(res, "api_remove_transf", __LINE__, cfg))
+            {
+                retVal = false;
+                break;
+            }
+        }
+
+        ENTITY_LIST faces;
+        res = api_get_faces(body, faces);
+        if (!checkOutcome(res, "api_get_faces", __LINE__, cfg))
+        {
+            retVal = false;
+            break;
+        }
+
+        Json::Value bodyDef;
+        SPAbox bodyBox;
+        bodyDef["body"] = numBodies;
+        bodyDef["face_count"] = faces.iteration_count();
+        if (!entityBox(body, bodyDef["bbox"], bodyBox, cfg))
+        {
+            retVal = false;
+            break;
+        }
+
+        Json::Value facesDef = Json::Value(Json::arrayValue);
+        for (int j = 0; j < faces.iteration_count(); j++)
+        {
+            FACE *face = (FACE *)faces[j];
+            Json::Value faceDef;
+            SPAbox faceBox;
+            faceDef["face"] = j;
+            faceDef["type"] = faceTypeName(face);
+            faceDef["reversed"] = int(face->sense());
+            if (!entityBox(face, faceDef["bbox"], faceBox, cfg))
+            {
+                retVal = false;
+                break;
+            }
+            sampleFace(face, faceBox, cfg.gen_samples(), faceDef["samples"]);
+            typeCounts[faceTypeName(face)]++;
+            facesDef.append(faceDef);
+        }
+        bodyDef["faces"] = facesDef;
+        bodiesDef.append(bodyDef);
+        numFaces += faces.iteration_count();
+        numBodies++;
+    }
+
+    // Delete the entities read back
+    for (int i = 0; i < readList.iteration_count(); i++)
+        api_del_entity(readList[i]);
+
+    if (!retVal)
+        return false;
+
+    root["body_count"] = numBodies;
+    root["face_count"] = numFaces;
+    Json::Value typesDef = Json::Value(Json::objectValue);
+    for (auto t : typeCounts)
+        typesDef[t.first] = t.second;
+    root["surface_types"] = typesDef;
+    root["bodies"] = bodiesDef;
+
+    // Write the ground truth file
+    std::string truthFile = cfg.gen_truth();
+    std::ofstream fileSave(truthFile.c_str(), std::ios::out);
+    if (!fileSave)
+    {
+        logMessage(LOG_ERROR, "file", "Cannot open file '" + truthFile + "' for writing!");
+        return false;
+    }
+    Json::StreamWriterBuilder wbuilder;
+    wbuilder["indentation"] = "\t";
+    fileSave << Json::writeString(wbuilder, root) << std::endl;
+    fileSave.close();
+
+    return true;
+}
@@ -0,0 +1,71 @@
+/*
+Copyright (c) 2019, Integrated Design and Engineering Analysis Laboratory (IDEA Lab) at Iowa State University.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef GENERATE_H
+#define GENERATE_H
+
+#include <vector>
+#include <random>
+#include <cmath>
+#include <algorithm>
+
+#include "common_acis.h"
+
+
+// Generator configuration, the generator options are added to the common options
+struct GenConfig : public Config {
+    GenConfig();
+
+    // Methods
+    std::string gen_mode();
+    int gen_bodies();
+    int gen_faces();
+    double gen_spline_ratio();
+    int gen_degree();
+    int gen_size();
+    int gen_holes();
+    int gen_seed();
+    std::string gen_pattern();
+    std::string gen_pattern_spacing();
+    double gen_pattern_rotate();
+    std::string gen_pattern_seed();
+    bool gen_unite();
+    std::string gen_stress_cases();
+    int gen_stress_degree();
+    int gen_stress_edges();
+    std::string gen_truth();
+    int gen_samples();
+};
+
+// Function prototypes
+bool generateSample(GenConfig &, ENTITY_LIST &);
+bool generateCorpus(GenConfig &, ENTITY_LIST &);
+bool generatePattern(GenConfig &, ENTITY_LIST &);
+bool generateStress(GenConfig &, ENTITY_LIST &);
+bool writeGroundTruth(GenConfig &, std::string &);
+
+#endif /* GENERATE_H */
@@ -0,0 +1,294 @@
+/*
+Copyright (c) 2019, Integrated Design and Engineering Analysis Laboratory (IDEA Lab) at Iowa State University.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "log.h"
+
+
+// Buffer size that triggers writing the buffered messages
+static const std::size_t logBufferSize = 64 * 1024;
+
+// Names of the log levels
+static const char *logLevelNames[] = { "debug", "info", "success", "warning", "error" };
+static const char *logLevelTags[] = { "[DEBUG] ", "[INFO] ", "[SUCCESS] ", "[WARNING] ", "[ERROR] " };
+
+Logger::Logger() : level(LOG_INFO), jsonLines(false), async(false), limit(0), stopping(false), busy(false)
+{
+    startTime = std::chrono::steady_clock::now();
+}
+
+Logger::~Logger()
+{
+    finish();
+}
+
+void Logger::configure(Config &cfg)
+{
+    // Write the messages logged so far with the previous configuration
+    flush();
+    stopWriter();
+
+    std::lock_guard<std::mutex> lock(mtx);
+    std::string levelName = cfg.log_level();
+    for (int l = LOG_DEBUG; l <= LOG_ERROR; l++)
+    {
+        if (levelName == logLevelNames[l])
+            level = LogLevel(l);
+    }
+    jsonLines = (cfg.log_format() == "jsonl");
+    limit = cfg.log_limit();
+    async = cfg.log_async();
+    if (fileLog.is_open())
+        fileLog.close();
+    if (!cfg.log_file().empty())
+    {
+        fileLog.open(cfg.log_file().c_str(), std::ios::out | std::ios::app);
+        if (!fileLog)
+            std::cerr << "[ERROR] Cannot open file '" << cfg.log_file() << "' for writing!" << std::endl;
+    }
+    if (async)
+    {
+        stopping = false;
+        writer = std::thread(&Logger::writerLoop, this);
+    }
+}
+
+bool Logger::enabled(LogLevel msgLevel)
+{
+    return msgLevel >= level;
+}
+
+void Logger::log(LogLevel msgLevel, const std::string &type, const std::string &message)
+{
+    if (msgLevel < level)
+        return;
+
+    std::unique_lock<std::mutex> lock(mtx);
+
+    // Rate limiting per message type, the errors and the reports of the written files are never suppressed
+    if (limit > 0 && msgLevel != LOG_SUCCESS && msgLevel < LOG_ERROR && ++counts[type] > limit)
+        return;
+
+    buffer += format(msgLevel, type, message);
+
+    // Errors are written immediately, other messages when the buffer is full
+    if (msgLevel >= LOG_ERROR || buffer.size() >= logBufferSize)
+    {
+        if (async && writer.joinable())
+            cv.notify_one();
+        else
+        {
+            std::string out;
+            out.swap(buffer);
+            write(out);
+        }
+    }
+}
+
+void Logger::flush()
+{
+    std::unique_lock<std::mutex> lock(mtx);
+    if (async && writer.joinable())
+    {
+        cv.notify_one();
+        cvDone.wait(lock, [this] { return buffer.empty() && !busy; });
+    }
+    else
+    {
+        std::string out;
+        out.swap(buffer);
+        write(out);
+    }
+}
+
+// Report the suppressed messages and write everything
+void Logger::finish()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        for (auto c : counts)
+        {
+            if (limit > 0 && c.second > limit)
+            {
+                std::string message = std::to_string(c.second - limit) + " more '" + c.first + "' messages were suppressed";
+                buffer += format(LOG_INFO, "log_summary", message);
+            }
+        }
+        counts.clear();
+    }
+    flush();
+    stopWriter();
+}
+
+// Write everything and stop the background writer before fork(), the child process has no writer thread and
+// writes its messages directly
+void Logger::suspend()
+{
+    flush();
+    stopWriter();
+}
+
+// Restart the background writer in the parent process after fork()
+void Logger::resume()
+{
+    std::lock_guard<std::mutex> lock(mtx);
+    if (async && !writer.joinable())
+    {
+        stopping = false;
+        writer = std::thread(&Logger::writerLoop, this);
+    }
+}
+
+std::string Logger::format(LogLevel msgLevel, const std::string &type, const std::string &message)
+{
+    if (!jsonLines)
+        return logLevelTags[msgLevel] + message + "\n";
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return "{\"time\":" + std::to_string(elapsed) + ",\"level\":\"" + logLevelNames[msgLevel] +
+        "\",\"type\":\"" + jsonEscape(type) + "\",\"message\":\"" + jsonEscape(message) + "\"}\n";
+}
+
+void Logger::write(const std::string &out)
+{
+    if (out.empty())
+        return;
+    if (fileLog.is_open())
+        fileLog.write(out.data(), out.size()).flush();
+    else
+        std::cout.write(out.data(), out.size()).flush();
+}
+
+// Background writer of the asynchronous mode
+void Logger::writerLoop()
+{
+    std::unique_lock<std::mutex> lock(mtx);
+    while (true)
+    {
+        cv.wait(lock, [this] { return !buffer.empty() || stopping; });
+        if (buffer.empty() && stopping)
+            break;
+        writing.swap(buffer);
+        busy = true;
+        lock.unlock();
+        write(writing);
+        writing.clear();
+        lock.lock();
+        busy = false;
+        cvDone.notify_all();
+    }
+}
+
+void Logger::stopWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    cv.notify_one();
+    if (writer.joinable())
+        writer.join();
+}
+
+// Global logger
+Logger &getLogger()
+{
+    static Logger logger;
+    return logger;
+}
+
+void configureLog(Config &cfg)
+{
+    getLogger().configure(cfg);
+}
+
+bool logEnabled(LogLevel msgLevel)
+{
+    return getLogger().enabled(msgLevel);
+}
+
+void logMessage(LogLevel msgLevel, const std::string &type, const std::string &message)
+{
+    getLogger().log(msgLevel, type, message);
+}
+
+void flushLog()
+{
+    getLogger().flush();
+}
+
+void finishLog()
+{
+    getLogger().finish();
+}
+
+void suspendLog()
+{
+    getLogger().suspend();
+}
+
+void resumeLog()
+{
+    getLogger().resume();
+}
+
+// Escape the string for JSON output
+std::string jsonEscape(const std::string &str)
+{
+    std::string escaped;
+    escaped.reserve(str.size());
+    for (char c : str)
+    {
+        switch (c)
+        {
+        case '"':
+            escaped += "\\\"";
+            break;
+        case '\\':
+            escaped += "\\\\";
+            break;
+        case '\n':
+            escaped += "\\n";
+            break;
+        case '\t':
+            escaped += "\\t";
+            break;
+        case '\r':
+            escaped += "\\r";
+            break;
+        default:
+            if ((unsigned char)c < 0x20)
+            {
+                char hex[8];
+                std::snprintf(hex, sizeof(hex), "\\u%04x", (unsigned char)c);
+                escaped += hex;
+            }
+            else
+                escaped += c;
+        }
+    }
+    return escaped;
+}
@@ -0,0 +1,104 @@
+/*
+Copyright (c) 2019, Integrated Design and Engineering Analysis Laboratory (IDEA Lab) at Iowa State University.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef LOG_H
+#define LOG_H
+
+#include <string>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+
+#include "common.h"
+
+
+// Log levels
+enum LogLevel {
+    LOG_DEBUG = 0,
+    LOG_INFO,
+    LOG_SUCCESS,
+    LOG_WARNING,
+    LOG_ERROR
+};
+
+// Buffered logger with rate limiting per message type
+class Logger {
+public:
+    Logger();
+    ~Logger();
+
+    void configure(Config &);
+    bool enabled(LogLevel);
+    void log(LogLevel, const std::string &, const std::string &);
+    void flush();
+    void finish();
+    void suspend();
+    void resume();
+
+private:
+    // Configuration
+    LogLevel level;
+    bool jsonLines;
+    bool async;
+    int limit;
+    std::ofstream fileLog;
+
+    // Message counts per message type
+    std::map<std::string, int> counts;
+
+    // Buffered messages
+    std::string buffer;
+    std::string writing;
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::condition_variable cvDone;
+    std::thread writer;
+    bool stopping;
+    bool busy;
+    std::chrono::steady_clock::time_point startTime;
+
+    // Methods
+    std::string format(LogLevel, const std::string &, const std::string &);
+    void write(const std::string &);
+    void writerLoop();
+    void stopWriter();
+};
+
+// Function prototypes
+Logger &getLogger();
+void configureLog(Config &);
+bool logEnabled(LogLevel);
+void logMessage(LogLevel, const std::string &, const std::string &);
+void flushLog();
+void finishLog();
+void suspendLog();
+void resumeLog();
+std::string jsonEscape(const std::string &);
+
+#endif /* LOG_H */
@@ -0,0 +1,579 @@
+/*
+Copyright (c) 2019, Integrated Design and Engineering Analysis Laboratory (IDEA Lab) at Iowa State University.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "perf.h"
+#include "log.h"
+#include "trace.h"
+
+#include <vector>
+#include <unordered_map>
+#include <sstream>
+#include <iomanip>
+#include <cstring>
+#include <algorithm>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+// Names of the phases and the counters in the reports
+static const char *phaseNames[PHASE_COUNT] = { "restore", "split", "convert", "extract", "serialize", "write", "wait" };
+static const char *counterNames[COUNTER_COUNT] = { "cycles", "instructions", "cache misses", "page faults" };
+
+// Recording state, the phases are recorded only in the thread running the conversion
+static bool enabled = false;
+static int counterFds[COUNTER_COUNT] = { -1, -1, -1, -1 };
+static std::chrono::steady_clock::time_point startTime;
+static std::vector<PerfPhase> phaseStack;
+static PerfSample baseSample;
+static PerfSample lastSample;
+static PerfSample phaseTotals[PHASE_COUNT];
+static long long phaseCalls[PHASE_COUNT] = {};
+
+// Totals of the child and worker processes merged into the phase totals
+static PerfSample mergedTotal;
+static int mergedCount = 0;
+
+// Latency of the ACIS API calls
+struct ApiStat {
+    long long count = 0;
+    double total = 0.0;
+    double max = 0.0;
+};
+
+// Number of the API calls in the table (0: latencies are not recorded)
+static int apiTop = 0;
+static std::unordered_map<std::string, ApiStat> apiStats;
+
+// Processing time of a face
+struct FaceTime {
+    int body;
+    int face;
+    std::string type;
+    std::string status;
+    long long surfCtrlpts;
+    long long trimCtrlpts;
+    double seconds[FACE_STAGE_COUNT];
+    double total;
+};
+
+// Number of the slowest faces in the report (0: faces are not recorded), the slowest faces are kept in a min-heap
+static int slowTop = 0;
+static std::vector<FaceTime> slowFaces;
+static std::vector<double> faceTotals;
+static const char *faceStageNames[FACE_STAGE_COUNT] = { "convert", "extract", "trims" };
+
+static bool fasterFace(const FaceTime &a, const FaceTime &b)
+{
+    return a.total > b.total;
+}
+
+// Keep the slowest faces, the fastest of them is on the top of the heap
+static void addSlowFace(const FaceTime &f)
+{
+    if (slowFaces.size() < std::size_t(slowTop))
+    {
+        slowFaces.push_back(f);
+        std::push_heap(slowFaces.begin(), slowFaces.end(), fasterFace);
+    }
+    else if (f.total > slowFaces.front().total)
+    {
+        std::pop_heap(slowFaces.begin(), slowFaces.end(), fasterFace);
+        slowFaces.back() = f;
+        std::push_heap(slowFaces.begin(), slowFaces.end(), fasterFace);
+    }
+}
+
+#ifdef __linux__
+// Open a counter of the calling thread in user space
+static int openCounter(unsigned int type, unsigned long long config)
+{
+    struct perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return int(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+}
+#endif
+
+// Read the elapsed time and the counters (unavailable counters stay zero)
+static void readSample(PerfSample &sample)
+{
+    sample.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+#ifdef __linux__
+    for (int c = 0; c < COUNTER_COUNT; c++)
+    {
+        long long value = 0;
+        if (counterFds[c] >= 0 && read(counterFds[c], &value, sizeof(value)) == sizeof(value))
+            sample.counters[c] = value;
+    }
+#endif
+}
+
+// Add the difference of the samples to the total
+static void addSample(PerfSample &total, const PerfSample &from, const PerfSample &to)
+{
+    total.seconds += to.seconds - from.seconds;
+    for (int c = 0; c < COUNTER_COUNT; c++)
+        total.counters[c] += to.counters[c] - from.counters[c];
+}
+
+// Assign the time and counters since the last sample to the running phase
+static void updatePhase()
+{
+    PerfSample sample;
+    readSample(sample);
+    if (!phaseStack.empty())
+        addSample(phaseTotals[phaseStack.back()], lastSample, sample);
+    lastSample = sample;
+}
+
+// Format the time and the available counters of a sample
+static std::string formatSample(const PerfSample &sample)
+{
+    std::ostringstream msg;
+    msg << std::fixed << std::setprecision(3) << sample.seconds << " s";
+    for (int c = 0; c < COUNTER_COUNT; c++)
+    {
+        if (counterFds[c] >= 0)
+            msg << ", " << counterNames[c] << " " << sample.counters[c];
+    }
+    if (counterFds[COUNTER_CYCLES] >= 0 && counterFds[COUNTER_INSTRUCTIONS] >= 0 && sample.counters[COUNTER_CYCLES] > 0)
+        msg << ", IPC " << std::setprecision(2) << double(sample.counters[COUNTER_INSTRUCTIONS]) / sample.counters[COUNTER_CYCLES];
+    return msg.str();
+}
+
+// Convert the time and the counters of a sample to JSON and back
+static Json::Value sampleToJson(const PerfSample &sample)
+{
+    Json::Value sampleDef;
+    sampleDef["seconds"] = sample.seconds;
+    for (int c = 0; c < COUNTER_COUNT; c++)
+        sampleDef["counters"].append(Json::Int64(sample.counters[c]));
+    return sampleDef;
+}
+
+static void addJsonSample(PerfSample &total, const Json::Value &sampleDef)
+{
+    total.seconds += sampleDef["seconds"].asDouble();
+    for (int c = 0; c < COUNTER_COUNT && c < int(sampleDef["counters"].size()); c++)
+        total.counters[c] += sampleDef["counters"][c].asInt64();
+}
+
+// Start recording the phases if the 'perf' option is set and open the counters on Linux
+void configurePerf(Config &cfg)
+{
+    apiTop = std::max(cfg.api_stats(), 0);
+    slowTop = std::max(cfg.slow_faces(), 0);
+    enabled = cfg.perf();
+    if (!enabled)
+        return;
+
+    startTime = std::chrono::steady_clock::now();
+#ifdef __linux__
+    counterFds[COUNTER_CYCLES] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    counterFds[COUNTER_INSTRUCTIONS] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    counterFds[COUNTER_CACHE_MISSES] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    counterFds[COUNTER_PAGE_FAULTS] = openCounter(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS);
+#endif
+    for (int c = 0; c < COUNTER_COUNT; c++)
+    {
+        if (counterFds[c] < 0)
+            logMessage(LOG_WARNING, "perf", std::string("Performance counter of ") + counterNames[c] + " is not available (see /proc/sys/kernel/perf_event_paranoid), only the time is recorded");
+    }
+    readSample(baseSample);
+    lastSample = baseSample;
+}
+
+// Restart recording in a child process, the counters of the parent process are not inherited
+void restartPerf(Config &cfg)
+{
+#ifdef __linux__
+    for (int c = 0; c < COUNTER_COUNT; c++)
+    {
+        if (counterFds[c] >= 0)
+            close(counterFds[c]);
+        counterFds[c] = -1;
+    }
+#endif
+    phaseStack.clear();
+    resetPerf();
+    configurePerf(cfg);
+}
+
+// Clear the recorded data, e.g. in a worker process before each file, the running phases are kept
+void resetPerf()
+{
+    apiStats.clear();
+    slowFaces.clear();
+    faceTotals.clear();
+    for (int p = 0; p < PHASE_COUNT; p++)
+    {
+        phaseTotals[p] = PerfSample();
+        phaseCalls[p] = 0;
+    }
+    mergedTotal = PerfSample();
+    mergedCount = 0;
+    if (enabled)
+    {
+        readSample(baseSample);
+        lastSample = baseSample;
+    }
+}
+
+bool perfEnabled()
+{
+    return enabled;
+}
+
+void beginPhase(PerfPhase phase)
+{
+    beginTrace(phaseNames[phase], "phase");
+    if (!enabled)
+        return;
+    updatePhase();
+    phaseStack.push_back(phase);
+    phaseCalls[phase]++;
+}
+
+void endPhase()
+{
+    endTrace();
+    if (!enabled)
+        return;
+    updatePhase();
+    if (!phaseStack.empty())
+        phaseStack.pop_back();
+}
+
+PhaseScope::PhaseScope(PerfPhase phase)
+{
+    beginPhase(phase);
+}
+
+PhaseScope::~PhaseScope()
+{
+    endPhase();
+}
+
+BodyScope::BodyScope(int bodyIdx) : body(bodyIdx)
+{
+    if (enabled)
+        readSample(start);
+}
+
+// Report the time and the counters of the body including all of its phases
+BodyScope::~BodyScope()
+{
+    if (!enabled)
+        return;
+    PerfSample sample;
+    readSample(sample);
+    PerfSample total;
+    addSample(total, start, sample);
+    logMessage(LOG_INFO, "perf_body", "Body #" + std::to_string(body) + ": " + formatSample(total));
+}
+
+// Write the recorded data for the parent process, which merges it into its reports
+void serializePerf(Json::Value &perfDef)
+{
+    if (enabled)
+    {
+        PerfSample sample, total;
+        readSample(sample);
+        addSample(total, baseSample, sample);
+        perfDef["total"] = sampleToJson(total);
+        for (int p = 0; p < PHASE_COUNT; p++)
+        {
+            Json::Value &phaseDef = perfDef["phases"][phaseNames[p]];
+            phaseDef = sampleToJson(phaseTotals[p]);
+            phaseDef["calls"] = Json::Int64(phaseCalls[p]);
+        }
+    }
+
+    // All API calls are sent, the parent selects the top calls of the merged statistics
+    for (auto &a : apiStats)
+    {
+        Json::Value &apiDef = perfDef["api"][a.first];
+        apiDef["count"] = Json::Int64(a.second.count);
+        apiDef["total"] = a.second.total;
+        apiDef["max"] = a.second.max;
+    }
+
+    // The slowest faces and the times of all faces for the percentiles and the histogram
+    if (slowTop > 0)
+    {
+        Json::Value &facesDef = perfDef["faces"];
+        facesDef["totals"] = Json::Value(Json::arrayValue);
+        for (std::size_t j = 0; j < faceTotals.size(); j++)
+            facesDef["totals"].append(faceTotals[j]);
+        facesDef["slowest"] = Json::Value(Json::arrayValue);
+        for (std::size_t j = 0; j < slowFaces.size(); j++)
+        {
+            const FaceTime &f = slowFaces[j];
+            Json::Value faceDef;
+            faceDef["body"] = f.body;
+            faceDef["face"] = f.face;
+            faceDef["type"] = f.type;
+            faceDef["status"] = f.status;
+            faceDef["surf_ctrlpts"] = Json::Int64(f.surfCtrlpts);
+            faceDef["trim_ctrlpts"] = Json::Int64(f.trimCtrlpts);
+            for (int st = 0; st < FACE_STAGE_COUNT; st++)
+                faceDef["seconds"].append(f.seconds[st]);
+            faceDef["total"] = f.total;
+            facesDef["slowest"].append(faceDef);
+        }
+    }
+}
+
+// Add the data recorded by a child or worker process
+void mergePerf(const Json::Value &perfDef)
+{
+    if (enabled && perfDef.isMember("total"))
+    {
+        addJsonSample(mergedTotal, perfDef["total"]);
+        mergedCount++;
+        for (int p = 0; p < PHASE_COUNT; p++)
+        {
+            const Json::Value &phaseDef = perfDef["phases"][phaseNames[p]];
+            addJsonSample(phaseTotals[p], phaseDef);
+            phaseCalls[p] += phaseDef["calls"].asInt64();
+        }
+    }
+
+    if (apiTop > 0 && perfDef.isMember("api"))
+    {
+        const Json::Value &apiDefs = perfDef["api"];
+        for (Json::Value::const_iterator it = apiDefs.begin(); it != apiDefs.end(); ++it)
+        {
+            ApiStat &stat = apiStats[it.name()];
+            stat.count += (*it)["count"].asInt64();
+            stat.total += (*it)["total"].asDouble();
+            stat.max = std::max(stat.max, (*it)["max"].asDouble());
+        }
+    }
+
+    if (slowTop > 0 && perfDef.isMember("faces"))
+    {
+        const Json::Value &facesDef = perfDef["faces"];
+        for (Json::ArrayIndex j = 0; j < facesDef["totals"].size(); j++)
+            faceTotals.push_back(facesDef["totals"][j].asDouble());
+        for (Json::ArrayIndex j = 0; j < facesDef["slowest"].size(); j++)
+        {
+            const Json::Value &faceDef = facesDef["slowest"][j];
+            FaceTime f;
+            f.body = faceDef["body"].asInt();
+            f.face = faceDef["face"].asInt();
+            f.type = faceDef["type"].asString();
+            f.status = faceDef["status"].asString();
+            f.surfCtrlpts = faceDef["surf_ctrlpts"].asInt64();
+            f.trimCtrlpts = faceDef["trim_ctrlpts"].asInt64();
+            for (int st = 0; st < FACE_STAGE_COUNT; st++)
+                f.seconds[st] = faceDef["seconds"][st].asDouble();
+            f.total = faceDef["total"].asDouble();
+            addSlowFace(f);
+        }
+    }
+}
+
+// Print the time and the counters of each phase, the remaining time is reported as other. The data of the child
+// and worker processes is summed with the data of this process, the parent waiting for them is reported as wait.
+void printPerfSummary()
+{
+    if (!enabled)
+        return;
+
+    PerfSample sample, total;
+    readSample(sample);
+    addSample(total, baseSample, sample);
+    addSample(total, PerfSample(), mergedTotal);
+    PerfSample other = total;
+    for (int p = 0; p < PHASE_COUNT; p++)
+    {
+        other.seconds -= phaseTotals[p].seconds;
+        for (int c = 0; c < COUNTER_COUNT; c++)
+            other.counters[c] -= phaseTotals[p].counters[c];
+    }
+
+    if (mergedCount > 0)
+        std::cout << "Conversion phases (summed over this process and " << mergedCount << " results of the child processes):" << std::endl;
+    else
+        std::cout << "Conversion phases:" << std::endl;
+    for (int p = 0; p < PHASE_COUNT; p++)
+        std::cout << "  - " << phaseNames[p] << " (" << phaseCalls[p] << " calls): " << formatSample(phaseTotals[p]) << std::endl;
+    std::cout << "  - other: " << formatSample(other) << std::endl;
+    std::cout << "  - total: " << formatSample(total) << std::endl;
+}
+
+ApiScope::ApiScope(const char *apiName) : name(apiName), active(apiTop > 0), trace(apiName, "acis")
+{
+    if (active)
+        start = std::chrono::steady_clock::now();
+}
+
+ApiScope::~ApiScope()
+{
+    if (!active)
+        return;
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    ApiStat &stat = apiStats[name];
+    stat.count++;
+    stat.total += seconds;
+    stat.max = std::max(stat.max, seconds);
+}
+
+// Print the API calls with the largest total latency
+void printApiStats()
+{
+    if (apiTop <= 0)
+        return;
+
+    std::vector< std::pair<std::string, ApiStat> > sorted(apiStats.begin(), apiStats.end());
+    std::sort(sorted.begin(), sorted.end(), [](const std::pair<std::string, ApiStat> &a, const std::pair<std::string, ApiStat> &b) {
+        return a.second.total > b.second.total;
+    });
+    if (sorted.size() > std::size_t(apiTop))
+        sorted.resize(apiTop);
+
+    std::cout << "ACIS API calls (top " << apiTop << " by total time):" << std::endl;
+    for (std::size_t j = 0; j < sorted.size(); j++)
+    {
+        const ApiStat &stat = sorted[j].second;
+        std::cout << "  - " << sorted[j].first << ": " << stat.count << " calls, total " << std::fixed << std::setprecision(3) << stat.total
+            << " s, mean " << 1000.0 * stat.total / stat.count << " ms, max " << 1000.0 * stat.max << " ms" << std::endl;
+    }
+    std::cout.unsetf(std::ios::fixed);
+}
+
+FaceRecorder::FaceRecorder(int bodyIdx, int faceIdx) : active(slowTop > 0), body(bodyIdx), face(faceIdx), type("other"), status("ok"), surfCtrlpts(0), trimCtrlpts(0), seconds()
+{
+    if (active)
+        last = std::chrono::steady_clock::now();
+}
+
+// Add the time since the previous mark to the stage
+void FaceRecorder::mark(FaceStage stage)
+{
+    if (!active)
+        return;
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    seconds[stage] += std::chrono::duration<double>(now - last).count();
+    last = now;
+}
+
+// Exclude the time since the previous mark from the stages
+void FaceRecorder::skip()
+{
+    if (active)
+        last = std::chrono::steady_clock::now();
+}
+
+FaceRecorder::~FaceRecorder()
+{
+    if (!active)
+        return;
+    FaceTime f;
+    f.body = body;
+    f.face = face;
+    f.type = type;
+    f.status = status;
+    f.surfCtrlpts = surfCtrlpts;
+    f.trimCtrlpts = trimCtrlpts;
+    f.total = 0.0;
+    for (int s = 0; s < FACE_STAGE_COUNT; s++)
+    {
+        f.seconds[s] = seconds[s];
+        f.total += seconds[s];
+    }
+    faceTotals.push_back(f.total);
+    addSlowFace(f);
+}
+
+// Print the slowest faces and the histogram of the face processing times
+void printSlowFaces()
+{
+    if (slowTop <= 0)
+        return;
+
+    std::vector<FaceTime> sorted(slowFaces);
+    std::sort_heap(sorted.begin(), sorted.end(), fasterFace);
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Slowest faces (top " << slowTop << "):" << std::endl;
+    for (std::size_t j = 0; j < sorted.size(); j++)
+    {
+        const FaceTime &f = sorted[j];
+        std::cout << "  - Body #" << f.body << " Face #" << f.face << " (" << f.type << ", " << f.status << "): " << 1000.0 * f.total << " ms (";
+        for (int s = 0; s < FACE_STAGE_COUNT; s++)
+            std::cout << ((s > 0) ? ", " : "") << faceStageNames[s] << " " << 1000.0 * f.seconds[s] << " ms";
+        std::cout << "), control points: surface " << f.surfCtrlpts << ", trims " << f.trimCtrlpts << std::endl;
+    }
+
+    // Upper limits of the histogram bins in milliseconds (1-2-5 series), the last bin is unbounded
+    static const double binLimits[] = { 0.1, 0.2, 0.5, 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000 };
+    const int numLimits = int(sizeof(binLimits) / sizeof(binLimits[0]));
+    std::vector<long long> bins(numLimits + 1, 0);
+    for (std::size_t j = 0; j < faceTotals.size(); j++)
+    {
+        int b = 0;
+        while (b < numLimits && 1000.0 * faceTotals[j] >= binLimits[b])
+            b++;
+        bins[b]++;
+    }
+
+    std::vector<double> totals(faceTotals);
+    std::sort(totals.begin(), totals.end());
+    auto percentile = [&totals](double p) {
+        return totals.empty() ? 0.0 : 1000.0 * totals[std::size_t(p * (totals.size() - 1))];
+    };
+    std::cout << "Face processing time (" << totals.size() << " faces): p50 " << percentile(0.5) << " ms, p90 " << percentile(0.9)
+        << " ms, p99 " << percentile(0.99) << " ms, max " << percentile(1.0) << " ms" << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+    std::cout << std::setprecision(6);
+
+    // Print the bins between the first and the last non-empty bins
+    int first = 0;
+    while (first < numLimits && bins[first] == 0)
+        first++;
+    int lastBin = numLimits;
+    while (lastBin > first && bins[lastBin] == 0)
+        lastBin--;
+    for (int b = first; b <= lastBin && !totals.empty(); b++)
+    {
+        std::ostringstream range;
+        if (b < numLimits)
+            range << "< " << binLimits[b] << " ms";
+        else
+            range << ">= " << binLimits[numLimits - 1] << " ms";
+        std::cout << "  - " << range.str() << ": " << bins[b] << std::endl;
+    }
+}
@@ -0,0 +1,131 @@
+/*
+Copyright (c) 2019, Integrated Design and Engineering Analysis Laboratory (IDEA Lab) at Iowa State University.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef PERF_H
+#define PERF_H
+
+#include <chrono>
+
+#include "common.h"
+#include "trace.h"
+#include "json/json.h"
+
+
+// Conversion phases
+enum PerfPhase {
+    PHASE_RESTORE,
+    PHASE_SPLIT,
+    PHASE_CONVERT,
+    PHASE_EXTRACT,
+    PHASE_SERIALIZE,
+    PHASE_WRITE,
+    PHASE_WAIT,
+    PHASE_COUNT
+};
+
+// Hardware and software performance counters
+enum PerfCounter {
+    COUNTER_CYCLES,
+    COUNTER_INSTRUCTIONS,
+    COUNTER_CACHE_MISSES,
+    COUNTER_PAGE_FAULTS,
+    COUNTER_COUNT
+};
+
+// Elapsed time and counter values
+struct PerfSample {
+    double seconds = 0.0;
+    long long counters[COUNTER_COUNT] = {};
+};
+
+// Records the enclosed code as a phase, the time of the nested phases is excluded
+struct PhaseScope {
+    explicit PhaseScope(PerfPhase);
+    ~PhaseScope();
+};
+
+// Records the time and counters of the enclosed code as the totals of a body
+struct BodyScope {
+    explicit BodyScope(int);
+    ~BodyScope();
+
+    int body;
+    PerfSample start;
+};
+
+// Records the latency of the enclosed ACIS API call and traces it
+struct ApiScope {
+    explicit ApiScope(const char *);
+    ~ApiScope();
+
+    const char *name;
+    bool active;
+    std::chrono::steady_clock::time_point start;
+    TraceScope trace;
+};
+
+// Face processing stages
+enum FaceStage {
+    FACE_CONVERT,
+    FACE_EXTRACT,
+    FACE_TRIMS,
+    FACE_STAGE_COUNT
+};
+
+// Records the processing time of a face by stage, the face is reported when the recorder is destroyed. The time
+// between a mark and a skip (e.g. writing the face) is not assigned to any stage.
+struct FaceRecorder {
+    FaceRecorder(int, int);
+    ~FaceRecorder();
+    void mark(FaceStage);
+    void skip();
+
+    bool active;
+    int body;
+    int face;
+    const char *type;
+    const char *status;
+    long long surfCtrlpts;
+    long long trimCtrlpts;
+    double seconds[FACE_STAGE_COUNT];
+    std::chrono::steady_clock::time_point last;
+};
+
+// Function prototypes
+void configurePerf(Config &);
+void restartPerf(Config &);
+void resetPerf();
+void serializePerf(Json::Value &);
+void mergePerf(const Json::Value &);
+bool perfEnabled();
+void beginPhase(PerfPhase);
+void endPhase();
+void printPerfSummary();
+void printApiStats();
+void printSlowFaces();
+
+#endif /* PERF_H */
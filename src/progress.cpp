@@ -0,0 +1,246 @@
+/*
+Copyright (c) 2019, Integrated Design and Engineering Analysis Laboratory (IDEA Lab) at Iowa State University.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "progress.h"
+#include "log.h"
+
+#include <iomanip>
+
+
+// Progress reporting state
+static double interval = 0.0;
+static std::string statusFile;
+static std::chrono::steady_clock::time_point startTime;
+static std::chrono::steady_clock::time_point lastReport;
+
+// Batch progress, the files converted by this process or by the worker processes (no files: single file)
+static int fileTotal = 0;
+static int filesDone = 0;
+static bool filesByWorkers = false;
+static std::chrono::steady_clock::time_point batchStart;
+static std::chrono::steady_clock::time_point fileStart;
+
+// Loading and extraction progress of the file, the bodies are the bodies selected for this process
+static int loadPercentage = -1;
+static int currBody = -1;
+static int bodyTotal = 0;
+static int bodiesDone = 0;
+static int faceTotal = 0;
+static int facesDoneBody = 0;
+static long long facesDone = 0;
+static long long ctrlptsDone = 0;
+static std::chrono::steady_clock::time_point extractStart;
+
+static double secondsSince(const std::chrono::steady_clock::time_point &t, const std::chrono::steady_clock::time_point &now)
+{
+    return std::chrono::duration<double>(now - t).count();
+}
+
+// Estimate the remaining time from the observed throughput, i.e. the time spent on the completed bodies and files
+static double estimateRemaining(const std::string &state, const std::chrono::steady_clock::time_point &now)
+{
+    if (state == "done")
+        return 0.0;
+
+    // Files converted by the worker processes in parallel
+    if (filesByWorkers)
+        return (filesDone > 0) ? (fileTotal - filesDone) * secondsSince(batchStart, now) / filesDone : -1.0;
+
+    // Remaining bodies of the file, the current body is counted by its processed faces
+    double fileRemaining = -1.0;
+    double fileElapsed = secondsSince(fileStart, now);
+    if (state == "extracting" && bodyTotal > 0)
+    {
+        double bodiesFraction = bodiesDone + ((faceTotal > 0) ? double(facesDoneBody) / faceTotal : 0.0);
+        if (bodiesFraction > 0.0)
+            fileRemaining = (bodyTotal - bodiesFraction) * secondsSince(extractStart, now) / bodiesFraction;
+    }
+    if (fileTotal <= 0 || fileRemaining < 0.0)
+        return fileRemaining;
+
+    // Remaining files of the batch, estimated with the average time of the converted files (or of this file)
+    double fileSeconds = (filesDone > 0) ? secondsSince(batchStart, fileStart) / filesDone : fileElapsed + fileRemaining;
+    return fileRemaining + (fileTotal - filesDone - 1) * fileSeconds;
+}
+
+// Write the progress to the standard error or to the status file (replaced atomically)
+static void writeProgress(const std::string &state)
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    lastReport = now;
+    double elapsed = secondsSince(startTime, now);
+
+    // Throughput
+    long long faces = facesDone + facesDoneBody;
+    double facesRate = (elapsed > 0.0) ? faces / elapsed : 0.0;
+    double ctrlptsRate = (elapsed > 0.0) ? ctrlptsDone / elapsed : 0.0;
+    double eta = estimateRemaining(state, now);
+
+    // Resident memory
+    std::size_t rss = 0, peak = 0;
+    getMemoryUsage(rss, peak);
+
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+    if (statusFile.empty())
+    {
+        out << "[PROGRESS] ";
+        if (fileTotal > 0)
+            out << "File " << std::min(filesDone + (filesByWorkers ? 0 : 1), fileTotal) << "/" << fileTotal << ", ";
+        if (state == "loading")
+            out << "Loading " << loadPercentage << "%";
+        else if (filesByWorkers || currBody < 0)
+            out << "faces " << faces;
+        else
+            out << "Body " << bodiesDone + 1 << "/" << bodyTotal << ", faces " << faces << " (" << facesDoneBody << "/" << faceTotal << " in body)";
+        out << ", " << facesRate << " faces/s, " << ctrlptsRate << " ctrlpts/s";
+        if (eta >= 0.0)
+            out << ", ETA " << eta << " s";
+        out << ", RSS " << rss / (1024 * 1024) << " MB";
+        flushLog();
+        std::cerr << out.str() << std::endl;
+    }
+    else
+    {
+        out << "{\"state\":\"" << state << "\",\"elapsed\":" << elapsed << ",\"files_done\":" << filesDone << ",\"files\":" << fileTotal
+            << ",\"load_percentage\":" << loadPercentage << ",\"body\":" << currBody << ",\"bodies_done\":" << bodiesDone
+            << ",\"bodies\":" << bodyTotal << ",\"faces_done\":" << faces
+            << ",\"body_faces_done\":" << facesDoneBody << ",\"body_faces\":" << faceTotal
+            << ",\"faces_per_sec\":" << facesRate << ",\"ctrlpts_per_sec\":" << ctrlptsRate
+            << ",\"eta\":" << eta << ",\"rss\":" << rss << ",\"peak_rss\":" << peak << "}";
+        std::string tmpName = statusFile + ".tmp";
+        std::ofstream fileSave(tmpName.c_str(), std::ios::out | std::ios::trunc);
+        fileSave << out.str() << std::endl;
+        fileSave.close();
+        if (fileSave)
+            std::rename(tmpName.c_str(), statusFile.c_str());
+    }
+}
+
+// Check if the reporting interval has passed since the last report
+static bool reportDue()
+{
+    return interval > 0.0 && std::chrono::duration<double>(std::chrono::steady_clock::now() - lastReport).count() >= interval;
+}
+
+// Add the processed faces of the current body to the completed bodies
+static void finishBody()
+{
+    if (currBody < 0)
+        return;
+    facesDone += facesDoneBody;
+    facesDoneBody = 0;
+    bodiesDone++;
+    currBody = -1;
+}
+
+// Start the progress reporting
+void configureProgress(Config &cfg)
+{
+    interval = cfg.progress();
+    statusFile = cfg.progress_file();
+    startTime = std::chrono::steady_clock::now();
+    lastReport = startTime;
+    batchStart = startTime;
+    fileStart = startTime;
+    extractStart = startTime;
+}
+
+// Start the progress of the next file of the batch converted by this process
+void progressFile(int fileIdx, int fileCount)
+{
+    finishBody();
+    fileStart = std::chrono::steady_clock::now();
+    if (fileIdx == 0)
+        batchStart = fileStart;
+    filesDone = fileIdx;
+    fileTotal = fileCount;
+    loadPercentage = -1;
+    bodyTotal = 0;
+    bodiesDone = 0;
+}
+
+// Update the progress with the files converted by the worker processes
+void progressFilesDone(int doneCount, int fileCount, Statistics &stats)
+{
+    filesByWorkers = true;
+    filesDone = doneCount;
+    fileTotal = fileCount;
+    facesDone = stats.faces;
+    ctrlptsDone = stats.surfCtrlpts + stats.trimCtrlpts;
+    if (reportDue())
+        writeProgress("converting");
+}
+
+// Report the loading progress, e.g. from the progress callbacks of the geometry kernel
+void progressLoad(int percentage)
+{
+    loadPercentage = percentage;
+    if (reportDue())
+        writeProgress("loading");
+}
+
+// Start the extraction progress of the bodies selected for this process in the loaded file
+void progressBodies(int bodyCount)
+{
+    finishBody();
+    extractStart = std::chrono::steady_clock::now();
+    bodyTotal = bodyCount;
+    bodiesDone = 0;
+}
+
+// Start the progress of the body with the given face count
+void progressBody(int bodyIdx, int faceCount)
+{
+    finishBody();
+    currBody = bodyIdx;
+    faceTotal = faceCount;
+    facesDoneBody = 0;
+}
+
+// Update the progress with the number of faces processed in the current body
+void progressFace(int faceCount, Statistics &stats)
+{
+    facesDoneBody = faceCount;
+    ctrlptsDone = stats.surfCtrlpts + stats.trimCtrlpts;
+    if (reportDue())
+        writeProgress("extracting");
+}
+
+// Write the final progress report
+void finishProgress(Statistics &stats)
+{
+    if (interval <= 0.0)
+        return;
+    finishBody();
+
+    // The faces extracted by the worker and child processes are known only from the statistics
+    if (filesByWorkers || facesDone == 0)
+        facesDone = stats.faces;
+    ctrlptsDone = stats.surfCtrlpts + stats.trimCtrlpts;
+    writeProgress("done");
+}
@@ -0,0 +1,307 @@
+/*
+Copyright (c) 2019, Integrated Design and Engineering Analysis Laboratory (IDEA Lab) at Iowa State University.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "rwsat.h"
+
+
+// Record a face which cannot be extracted (failed or out of time), the remaining faces are processed as usual
+static bool faceSkipped(int bodyIdx, int faceIdx, const std::string &action, Statistics &stats, Sink &sink, FaceRecorder &faceTime)
+{
+    std::string faceStr = "Face #" + std::to_string(faceIdx) + " of Body #" + std::to_string(bodyIdx);
+    if (budgetExpired())
+    {
+        faceTime.status = "timeout";
+        logMessage(LOG_ERROR, "face_timeout", "Time budget is exceeded before the operation to " + action + " " + faceStr + " is finished. Skipping...");
+        stats.facesTimedOut++;
+        return sink.skipFace(faceIdx, "timeout");
+    }
+    logMessage(LOG_ERROR, "face_failed", "Cannot " + action + " " + faceStr + ". Skipping...");
+    faceTime.status = "failed";
+    stats.facesFailed++;
+    return sink.skipFace(faceIdx, "failed");
+}
+
+// Count the selected bodies of the shard
+static int countSelectedBodies(Filter &filter, int bodyCount, int shard, int shardCount)
+{
+    int selected = 0;
+    for (int i = shard; i < bodyCount; i += shardCount)
+    {
+        if (filter.selectBody(i))
+            selected++;
+    }
+    return selected;
+}
+
+// Extract the selected faces of the body and write them to the sink
+// (failing bodies and faces are recorded in the statistics and skipped, false is returned only if the output fails)
+bool extractBody(Backend &backend, int bodyIdx, Config &cfg, Filter &filter, Statistics &stats, Sink &sink)
+{
+    // Skip the body if the time budget of the file is used up
+    if (fileBudgetExpired())
+    {
+        logMessage(LOG_ERROR, "body_timeout", "Time budget of the file is used up before Body #" + std::to_string(bodyIdx) + ". Skipping...");
+        stats.bodiesTimedOut++;
+        return true;
+    }
+
+    // Record the time and counters of the body, the nested phases are excluded from extraction
+    TraceScope bodyTrace("Body", bodyIdx, "body");
+    BodyScope bodyPerf(bodyIdx);
+    PhaseScope extractPhase(PHASE_EXTRACT);
+
+    // Prepare the body, e.g. split periodic faces and remove transformations
+    if (!backend.beginBody(bodyIdx, cfg, stats))
+    {
+        logMessage(LOG_ERROR, "body_failed", "Cannot prepare Body #" + std::to_string(bodyIdx) + ". Skipping...");
+        stats.bodiesFailed++;
+        return true;
+    }
+
+    // Compute the owner transformation once for all faces of the body
+    double affine[12];
+    bool hasTransform = cfg.transform() && backend.bodyTransform(affine);
+
+    // Get face count
+    int body_count = backend.bodyCount();
+    int face_count = backend.faceCount();
+    progressBody(bodyIdx, face_count);
+
+    // Start writing the shape
+    if (!sink.beginShape(bodyIdx, body_count))
+        return false;
+
+    // Number of the extracted surfaces
+    int surf_count = 0;
+
+    for (int j = 0; j < face_count; j++)
+    {
+        // Report the progress periodically
+        progressFace(j, stats);
+
+        // Skip the face if it is not selected
+        if (!filter.selectFace(backend, j))
+            continue;
+
+        // Start the time budget of the face, the geometry kernel may interrupt the operations when it is exceeded
+        TraceScope faceTrace("Face", j, "face");
+        FaceRecorder faceTime(bodyIdx, j);
+        if (faceTime.active)
+            faceTime.type = surfaceTypeName(backend.surfaceType(j));
+        FaceBudgetScope faceBudget(cfg.face_timeout());
+
+        // Convert the underlying geometry to B-spline representation
+        bool converted;
+        {
+            PhaseScope convertPhase(PHASE_CONVERT);
+            converted = !budgetExpired() && (!cfg.bspline() || backend.convertFace(j, cfg));
+        }
+        faceTime.mark(FACE_CONVERT);
+        if (!converted)
+        {
+            if (!faceSkipped(bodyIdx, j, "convert the geometry of", stats, sink, faceTime))
+                return false;
+            continue;
+        }
+
+        /*** SURFACE EXTRACTION ***/
+
+        // Check if the face has a spline surface or skip the face
+        if (backend.surfaceType(j) != SURFACE_SPLINE)
+        {
+            faceTime.status = "not_spline";
+            if (cfg.warnings())
+                logMessage(LOG_WARNING, "face_not_spline", "Face #" + std::to_string(j) + " of Body #" + std::to_string(bodyIdx) + " does not have a spline surface. Skipping...");
+            continue;
+        }
+
+        // Extract the spline surface from the face
+        Surface surfData;
+        double surf_param_offset[2];
+        double surf_param_len[2];
+        bool extracted = !budgetExpired() && backend.getSurface(j, cfg, surfData, surf_param_offset, surf_param_len);
+        faceTime.mark(FACE_EXTRACT);
+        if (!extracted)
+        {
+            if (!faceSkipped(bodyIdx, j, "extract B-spline surface from", stats, sink, faceTime))
+                return false;
+            continue;
+        }
+
+        // Extract the trim loops before writing, a failing face is not written partially
+        std::vector<TrimLoop> trims;
+        bool trimmed = !cfg.trims() || (!budgetExpired() && backend.getTrims(j, cfg, trims));
+        faceTime.mark(FACE_TRIMS);
+        if (!trimmed)
+        {
+            if (!faceSkipped(bodyIdx, j, "extract trim curves from", stats, sink, faceTime))
+                return false;
+            continue;
+        }
+
+        surfData.id = j + (body_count * bodyIdx);
+        surfData.face = j;
+        surfData.reversed = backend.faceReversed(j);
+        faceTime.surfCtrlpts = extractSurfaceData(surfData, cfg, (hasTransform) ? affine : NULL);
+        stats.surfCtrlpts += faceTime.surfCtrlpts;
+        faceTime.mark(FACE_EXTRACT);
+        if (!sink.writeSurface(surfData))
+            return false;
+        faceTime.skip();
+        surf_count++;
+
+        /*** TRIM CURVE EXTRACTION ***/
+
+        if (cfg.trims())
+        {
+            for (std::size_t lid = 0; lid < trims.size(); lid++)
+            {
+                TrimLoop &trimLoop = trims[lid];
+                for (std::size_t ce = 0; ce < trimLoop.curves.size(); ce++)
+                    faceTime.trimCtrlpts += extractTrimCurveData(trimLoop.curves[ce], cfg, surf_param_offset, surf_param_len);
+            }
+            stats.trimCtrlpts += faceTime.trimCtrlpts;
+            faceTime.mark(FACE_TRIMS);
+            if (!sink.writeTrims(trims))
+                return false;
+            faceTime.skip();
+        }
+    }
+
+    progressFace(face_count, stats);
+
+    // Finish writing the shape
+    if (!sink.endShape())
+        return false;
+
+    // Update statistics
+    stats.faces += surf_count;
+    stats.bodies++;
+
+    return true;
+}
+
+// Extract the selected bodies of the model loaded by the backend
+bool extractShapes(Backend &backend, Config &cfg, Statistics &stats, std::vector<Shape> &shapes)
+{
+    // Initialize body and face selection filters
+    Filter filter(cfg);
+    if (!filter.valid)
+        return false;
+
+    // Collect the shapes in memory
+    MemorySink sink(shapes);
+
+    // The progress is estimated from the selected bodies
+    int body_count = backend.bodyCount();
+    progressBodies(countSelectedBodies(filter, body_count, 0, 1));
+
+    bool retVal = true;
+    for (int i = 0; i < body_count; i++)
+    {
+        // Skip the body if it is not selected
+        if (!filter.selectBody(i))
+            continue;
+
+        if (!extractBody(backend, i, cfg, filter, stats, sink))
+            retVal = false;
+    }
+
+    return retVal;
+}
+
+// Extract the selected bodies of the shard, i.e. the bodies with index % shardCount == shard
+bool extractBodies(Backend &backend, Config &cfg, Filter &filter, Statistics &stats, Sink &sink, int shard, int shardCount)
+{
+    // The progress is estimated from the selected bodies of the shard
+    int body_count = backend.bodyCount();
+    progressBodies(countSelectedBodies(filter, body_count, shard, shardCount));
+
+    for (int i = shard; i < body_count; i += shardCount)
+    {
+        // Skip the body if it is not selected
+        if (!filter.selectBody(i))
+            continue;
+
+        // Extract the spline geometry of the body and write it to the output sink
+        if (!extractBody(backend, i, cfg, filter, stats, sink))
+            return false;
+
+        // Release the body and its converted geometry
+        if (cfg.release())
+        {
+            printMemoryUsage("Before releasing Body #" + std::to_string(i));
+            backend.releaseBody(i, cfg);
+            printMemoryUsage("After releasing Body #" + std::to_string(i));
+        }
+    }
+    return true;
+}
+
+// Convert the model file with the started backend and write the output files named after the model file
+// (false is returned if the file cannot be read or the output cannot be written)
+bool convertFile(Backend &backend, const std::string &fileName, Config &cfg, Statistics &stats, std::vector<std::string> &outputs)
+{
+    // Start the time budget of the file
+    TraceScope fileTrace(fileName, "file");
+    beginFileBudget(cfg.file_timeout());
+
+    // Create the output sink
+    std::unique_ptr<Sink> sink(createSink(cfg, fileName.substr(0, fileName.find_last_of("."))));
+    if (!sink)
+    {
+        logMessage(LOG_ERROR, "config", "Unknown output format '" + cfg.output_format() + "'!");
+        return false;
+    }
+
+    // Initialize body and face selection filters (an invalid filter is a configuration error)
+    Filter filter(cfg);
+    if (!filter.valid)
+        return false;
+
+    // Read the model
+    beginPhase(PHASE_RESTORE);
+    bool loaded = backend.load(fileName, cfg);
+    endPhase();
+    if (!loaded)
+        return false;
+
+    // Extract the bodies in this process or in the child processes sharing the loaded model
+    bool retVal;
+    if (cfg.fork() > 1)
+        retVal = forkBodies(backend, cfg, filter, stats, *sink, outputs);
+    else
+    {
+        retVal = extractBodies(backend, cfg, filter, stats, *sink, 0, 1);
+        outputs = sink->outputFiles();
+    }
+
+    // Delete the model, the backend can load the next file
+    backend.unload(cfg);
+
+    return retVal;
+}
@@ -25,7 +25,7 @@ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
 SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
-#include "common.h"
+#include "generate.h"
 
 
 // SATGEN executable
@@ -39,9 +39,16 @@ int main(int argc, char **argv)
     // File name to write
     std::string fileName;
 
+    // Initialize configuration
+    GenConfig cfg;
+
     if (argc < 2 || argc > 3)
     {
         std::cout << "Usage: " << argv[0] << " FILENAME OPTIONS\n" << std::endl;
+        std::cout << "Available options:" << std::endl;
+        for (auto p : cfg.params)
+            std::cout << "  - " << p.first << ": " << p.second.second << std::endl;
+        std::cout << "\nExample: " << argv[0] << " corpus.sat gen_mode=corpus;gen_bodies=100;gen_faces=50;gen_holes=2" << std::endl;
 #ifdef _MSC_VER
         std::cout << "Note: A license key should be provided using 'license_key' or 'license_file' arguments." << std::endl;
 #endif
@@ -50,16 +57,17 @@ int main(int argc, char **argv)
     else
         fileName = std::string(argv[1]);
 
-    // Initialize configuration
-    Config cfg;
-
     // Update configuration
     if (argc == 3)
         parseConfig(argv[2], cfg);
 
+    // Set up logging
+    configureLog(cfg);
+
     // Print configuration
     if (cfg.show_config())
     {
+        flushLog();
         std::cout << "Using configuration:" << std::endl;
         for (auto p : cfg.params)
             std::cout << "  - " << p.first << ": " << p.second.first << std::endl;
@@ -70,111 +78,59 @@ int main(int argc, char **argv)
 
     // Start ACIS
     res = api_start_modeller();
-    checkOutcome(res, "api_start_modeller", __LINE__, cfg);
+    if (!checkOutcome(res, "api_start_modeller", __LINE__, cfg))
+    {
+        finishLog();
+        return EXIT_FAILURE;
+    }
  
     // Unlock ACIS (required only on Windows)
 #ifdef _MSC_VER
     if (!unlockACIS(cfg))
+    {
+        finishLog();
         return EXIT_FAILURE;
+    }
 #endif
 
     // Entities to be saved
     ENTITY_LIST saveList;
 
-    // Create a cuboid
-    BODY *cuboid;
-    res = api_make_cuboid(5, 10, 20, cuboid);
-    checkOutcome(res, "api_make_cuboid", __LINE__, cfg);
-
-    // Create transformation
-    SPAposition rotate_pos(20, 0, 0);
-    SPAtransf r = rotate_transf(M_PI / 4, SPAvector(0, 0, 1));
-    SPAvector to_rotate_pos = rotate_pos - SPAposition(0, 0, 0);
-    SPAtransf t = translate_transf(to_rotate_pos);
-    SPAtransf tc = t.inverse() * r * t;
-
-    // Transform cuboid
-    res = api_apply_transf(cuboid, tc);
-    checkOutcome(res, "api_apply_transf", __LINE__, cfg);
-    res = api_change_body_trans(cuboid, NULL);
-    checkOutcome(res, "api_change_body_trans", __LINE__, cfg);
-
-    // Add to save list
-    saveList.add(cuboid);
-
-    // Create a torus
-    BODY *torus;
-    res = api_make_torus(25, 12.5, torus);
-    checkOutcome(res, "api_make_torus", __LINE__, cfg);
-
-    // Create transformation
-    SPAposition translate_pos1(0, 0, -100);
-    SPAvector to_translate_pos1 = translate_pos1 - SPAposition(0, 0, 0);
-    SPAtransf tt1 = translate_transf(to_translate_pos1);
-
-    // Transform torus
-    res = api_apply_transf(torus, tt1);
-    checkOutcome(res, "api_apply_transf", __LINE__, cfg);
-    res = api_change_body_trans(torus, NULL);
-    checkOutcome(res, "api_change_body_trans", __LINE__, cfg);
-
-    // Add to save list
-    saveList.add(torus);
-
-    // Create a toroidal face
-    FACE *torodialFace;
-    SPAposition center(25, 25, 25);
-    SPAvector normal(0, 0, 1);
-    res = api_face_torus(center, 10, 2.5, 0, 360, 0, 180, &normal, torodialFace);
-    checkOutcome(res, "api_face_torus", __LINE__, cfg);
-
-    // Create a sheet body from the toroidal face
-    FACE *faces[1];
-    faces[0] = torodialFace;
-    BODY *torus2;
-    res = api_sheet_from_ff(1, faces, torus2);
-    checkOutcome(res, "api_sheet_from_ff", __LINE__, cfg);
-
-    // Create transformation
-    SPAposition translate_pos2(0, 0, -100);
-    SPAvector to_translate_pos2 = translate_pos2 - SPAposition(0, 0, 0);
-    SPAtransf tt2 = translate_transf(to_translate_pos1);
-
-    // Transform toroidal sheet body
-    res = api_apply_transf(torus2, tt2);
-    checkOutcome(res, "api_apply_transf", __LINE__, cfg);
-    res = api_change_body_trans(torus2, NULL);
-    checkOutcome(res, "api_change_body_trans", __LINE__, cfg);
-
-    // Add to save list
-    saveList.add(torus2);
-
-    // Make a sphere
-    BODY *sphere;
-    res = api_make_sphere(2.5, sphere);
-    checkOutcome(res, "api_make_sphere", __LINE__, cfg);
-
-    // Create transformation
-    SPAposition translate_pos3(100, 100, 0);
-    SPAvector to_translate_pos3 = translate_pos3 - SPAposition(0, 0, 0);
-    SPAtransf ts = translate_transf(to_translate_pos3);
-
-    // Transform sphere
-    res = api_apply_transf(sphere, ts);
-    checkOutcome(res, "api_apply_transf", __LINE__, cfg);
-    res = api_change_body_trans(sphere, NULL);
-    checkOutcome(res, "api_change_body_trans", __LINE__, cfg);
-
-    // Add to save list
-    saveList.add(sphere);
-    
+    // Generate the bodies
+    bool retVal = false;
+    if (cfg.gen_mode() == "sample")
+        retVal = generateSample(cfg, saveList);
+    else if (cfg.gen_mode() == "corpus")
+        retVal = generateCorpus(cfg, saveList);
+    else if (cfg.gen_mode() == "pattern")
+        retVal = generatePattern(cfg, saveList);
+    else if (cfg.gen_mode() == "stress")
+        retVal = generateStress(cfg, saveList);
+    else
+        logMessage(LOG_ERROR, "config", "Unknown generator mode '" + cfg.gen_mode() + "'!");
+
     // Save list as a .SAT file
-    if (saveSatFile(saveList, fileName, cfg))
-        std::cout << "[SUCCESS] '" << fileName << "' was generated successfully!" << std::endl;
+    if (retVal)
+    {
+        retVal = saveSatFile(saveList, fileName, cfg);
+        if (retVal)
+            logMessage(LOG_SUCCESS, "output", "'" + fileName + "' was generated successfully with " + std::to_string(saveList.iteration_count()) + " bodies");
+    }
+
+    // Write the ground truth for checking sat2json output
+    if (retVal && !cfg.gen_truth().empty())
+    {
+        retVal = writeGroundTruth(cfg, fileName);
+        if (retVal)
+            logMessage(LOG_INFO, "output", "Ground truth was written to '" + cfg.gen_truth() + "'");
+    }
 
     // Stop ACIS
     res = api_stop_modeller();
     checkOutcome(res, "api_stop_modeller", __LINE__, cfg);
 
-    return EXIT_SUCCESS;
+    // Write the buffered log messages
+    finishLog();
+
+    return retVal ? EXIT_SUCCESS : EXIT_FAILURE;
 }
@@ -0,0 +1,201 @@
+/*
+Copyright (c) 2019, Integrated Design and Engineering Analysis Laboratory (IDEA Lab) at Iowa State University.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "serialize.h"
+
+#include <fstream>
+
+
+// Convert the spline surface into geomdl JSON format
+void serializeSurface(const Surface &surf, Json::Value &surfDef)
+{
+    surfDef["id"] = surf.id;
+    surfDef["reversed"] = int(surf.reversed);
+    surfDef["rational"] = surf.rational;
+    surfDef["form_u"] = surf.degree_u;
+    surfDef["form_v"] = surf.degree_v;
+    surfDef["degree_u"] = surf.degree_u;
+    surfDef["degree_v"] = surf.degree_v;
+    Json::Value kvU;
+    for (std::size_t k = 0; k < surf.knotvector_u.size(); k++)
+        kvU.append(surf.knotvector_u[k]);
+    surfDef["knotvector_u"] = kvU;
+    Json::Value kvV;
+    for (std::size_t k = 0; k < surf.knotvector_v.size(); k++)
+        kvV.append(surf.knotvector_v[k]);
+    surfDef["knotvector_v"] = kvV;
+    surfDef["size_u"] = surf.size_u;
+    surfDef["size_v"] = surf.size_v;
+    Json::Value ctrlptsDef;
+    Json::Value pointsDef;
+    for (std::size_t idx = 0; idx < surf.ctrlpts.size() / 3; idx++)
+    {
+        Json::Value ptDef;
+        for (int c = 0; c < 3; c++)
+            ptDef[c] = surf.ctrlpts[3 * idx + c];
+        pointsDef.append(ptDef);
+    }
+    ctrlptsDef["points"] = pointsDef;
+    if (!surf.weights.empty())
+    {
+        Json::Value weightsDef;
+        for (std::size_t idx = 0; idx < surf.weights.size(); idx++)
+            weightsDef.append(surf.weights[idx]);
+        ctrlptsDef["weights"] = weightsDef;
+    }
+    surfDef["control_points"] = ctrlptsDef;
+
+    // Trim curves
+    if (surf.hasTrims)
+    {
+        Json::Value surfTrimDef;
+        serializeTrims(surf.trims, surfTrimDef);
+        surfDef["trims"] = surfTrimDef;
+    }
+}
+
+// Convert the trim loops into geomdl JSON format
+void serializeTrims(const std::vector<TrimLoop> &trims, Json::Value &surfTrimDef)
+{
+    Json::Value tDataDef;
+    for (std::size_t lid = 0; lid < trims.size(); lid++)
+    {
+        const TrimLoop &loop = trims[lid];
+
+        // Store each coedge data in a list
+        Json::Value tCurvesDataDef;
+        for (std::size_t ce = 0; ce < loop.curves.size(); ce++)
+        {
+            Json::Value curveDef;
+            serializeTrimCurve(loop.curves[ce], curveDef);
+            tCurvesDataDef.append(curveDef);
+        }
+
+        // Store each loop data in a list
+        Json::Value tDataDataDef;
+        tDataDataDef["type"] = "container";
+        tDataDataDef["data"] = tCurvesDataDef;
+        tDataDataDef["loop_type"] = loop.type;
+        if (loop.reversed >= 0)
+            tDataDataDef["reversed"] = loop.reversed;
+        tDataDef.append(tDataDataDef);
+    }
+
+    // Add trim curves to the parent JSON object
+    surfTrimDef["count"] = int(trims.size());
+    surfTrimDef["data"] = tDataDef;
+}
+
+// Convert the trim curve into geomdl JSON format
+void serializeTrimCurve(const TrimCurve &curve, Json::Value &curveDef)
+{
+    curveDef["reversed"] = int(curve.reversed);
+    curveDef["type"] = "spline";
+    curveDef["rational"] = curve.rational;
+    curveDef["degree"] = curve.degree;
+    Json::Value ckv;
+    for (std::size_t k = 0; k < curve.knotvector.size(); k++)
+        ckv.append(curve.knotvector[k]);
+    curveDef["knotvector"] = ckv;
+    Json::Value cctrlptsDef;
+    Json::Value cpointsDef;
+    for (std::size_t idx = 0; idx < curve.ctrlpts.size() / 2; idx++)
+    {
+        Json::Value cptDef;
+        for (int c = 0; c < 2; c++)
+            cptDef[c] = curve.ctrlpts[2 * idx + c];
+        cpointsDef.append(cptDef);
+    }
+    cctrlptsDef["points"] = cpointsDef;
+    if (!curve.weights.empty())
+    {
+        Json::Value cweightsDef;
+        for (std::size_t idx = 0; idx < curve.weights.size(); idx++)
+            cweightsDef.append(curve.weights[idx]);
+        cctrlptsDef["weights"] = cweightsDef;
+    }
+    curveDef["control_points"] = cctrlptsDef;
+}
+
+// Convert the skipped faces to JSON (not a part of the geomdl format, ignored by geomdl)
+void serializeSkipped(const std::vector<SkippedFace> &skipped, Json::Value &skippedDef)
+{
+    skippedDef = Json::Value(Json::arrayValue);
+    for (std::size_t j = 0; j < skipped.size(); j++)
+    {
+        Json::Value faceDef;
+        faceDef["face"] = skipped[j].face;
+        faceDef["reason"] = skipped[j].reason;
+        skippedDef.append(faceDef);
+    }
+}
+
+// Convert the shape into geomdl JSON format
+void serializeShape(const Shape &shape, Json::Value &root)
+{
+    // Create shape definition for JSON
+    Json::Value shapeDef;
+    shapeDef["type"] = "surface";
+
+    // Create data definition for JSON
+    Json::Value dataDef;
+    for (std::size_t j = 0; j < shape.surfaces.size(); j++)
+    {
+        Json::Value surfDef;
+        serializeSurface(shape.surfaces[j], surfDef);
+        dataDef.append(surfDef);
+    }
+
+    // Update root JSON object
+    shapeDef["count"] = int(shape.surfaces.size());
+    shapeDef["data"] = dataDef;
+    if (!shape.skipped.empty())
+        serializeSkipped(shape.skipped, shapeDef["skipped"]);
+    root["shape"] = shapeDef;
+}
+
+// Write the shape to a JSON file
+bool writeShapeFile(const Shape &shape, const std::string &fileName)
+{
+    // Try to open JSON file for writing
+    std::ofstream fileSave(fileName.c_str(), std::ios::out);
+    if (!fileSave)
+        return false;
+
+    // Convert JSON data structure into a string
+    Json::Value root;
+    serializeShape(shape, root);
+    Json::StreamWriterBuilder wbuilder;
+    wbuilder["indentation"] = "\t";
+    std::string jsonDocument = Json::writeString(wbuilder, root);
+
+    // Write JSON string to a file
+    fileSave << jsonDocument << std::endl;
+    fileSave.close();
+
+    return true;
+}
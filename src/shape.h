@@ -0,0 +1,91 @@
+/*
+Copyright (c) 2019, Integrated Design and Engineering Analysis Laboratory (IDEA Lab) at Iowa State University.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef SHAPE_H
+#define SHAPE_H
+
+#include <string>
+#include <vector>
+
+
+// Trim loop types (same values with ACIS loop_type)
+enum TrimLoopType {
+    TRIM_LOOP_UNKNOWN = 0,
+    TRIM_LOOP_PERIPHERY = 1,
+    TRIM_LOOP_HOLE = 2,
+    TRIM_LOOP_SEPARATION = 3
+};
+
+// Spline trim curve in the parametric space of the surface
+struct TrimCurve {
+    bool reversed = false;
+    bool rational = false;
+    int degree = 0;
+    std::vector<double> knotvector;
+    std::vector<double> ctrlpts;  // (u, v) pairs
+    std::vector<double> weights;  // empty if non-rational
+};
+
+// Trim loop (face boundary)
+struct TrimLoop {
+    int type = TRIM_LOOP_UNKNOWN;
+    int reversed = -1;  // 0: hole, 1: periphery, -1: unknown
+    std::vector<TrimCurve> curves;
+};
+
+// Spline surface extracted from a face
+struct Surface {
+    int id = 0;
+    int face = 0;
+    bool reversed = false;
+    bool rational = false;
+    int degree_u = 0;
+    int degree_v = 0;
+    std::vector<double> knotvector_u;
+    std::vector<double> knotvector_v;
+    int size_u = 0;
+    int size_v = 0;
+    std::vector<double> ctrlpts;  // (x, y, z) triplets, v index changes fastest
+    std::vector<double> weights;  // empty if non-rational
+    bool hasTrims = false;
+    std::vector<TrimLoop> trims;
+};
+
+// Face skipped during the extraction and the reason, e.g. failed or timeout
+struct SkippedFace {
+    int face = 0;
+    std::string reason;
+};
+
+// Surfaces extracted from a body
+struct Shape {
+    int body = 0;
+    std::vector<Surface> surfaces;
+    std::vector<SkippedFace> skipped;
+};
+
+#endif /* SHAPE_H */
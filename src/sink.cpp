@@ -0,0 +1,113 @@
+/*
+Copyright (c) 2019, Integrated Design and Engineering Analysis Laboratory (IDEA Lab) at Iowa State University.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "sink.h"
+#include "sink_json.h"
+
+
+MemorySink::MemorySink(std::vector<Shape> &shapeList) : shapes(shapeList)
+{
+}
+
+bool MemorySink::beginShape(int bodyIdx, int)
+{
+    shapes.push_back(Shape());
+    shapes.back().body = bodyIdx;
+    return true;
+}
+
+bool MemorySink::endShape()
+{
+    return true;
+}
+
+bool MemorySink::writeSurface(Surface &surf)
+{
+    shapes.back().surfaces.push_back(surf);
+    return true;
+}
+
+bool MemorySink::writeTrims(std::vector<TrimLoop> &trims)
+{
+    Surface &surf = shapes.back().surfaces.back();
+    surf.hasTrims = true;
+    surf.trims.swap(trims);
+    return true;
+}
+
+bool MemorySink::skipFace(int faceIdx, const std::string &reason)
+{
+    SkippedFace skipped;
+    skipped.face = faceIdx;
+    skipped.reason = reason;
+    shapes.back().skipped.push_back(skipped);
+    return true;
+}
+
+bool NullSink::beginShape(int, int)
+{
+    return true;
+}
+
+bool NullSink::endShape()
+{
+    return true;
+}
+
+bool NullSink::writeSurface(Surface &)
+{
+    return true;
+}
+
+bool NullSink::writeTrims(std::vector<TrimLoop> &)
+{
+    return true;
+}
+
+bool NullSink::skipFace(int, const std::string &)
+{
+    return true;
+}
+
+// Create the output sink selected in the configuration, output files are named after the base name
+Sink *createSink(Config &cfg, const std::string &baseName)
+{
+    std::string format = cfg.output_format();
+    if (format == "json")
+        return new JsonSink(baseName);
+    if (format == "json_stream")
+        return new JsonStreamSink(baseName);
+    if (format == "none")
+        return new NullSink();
+    return NULL;
+}
+
+// Generate output file name of the body
+std::string outputFileName(const std::string &baseName, int bodyIdx, int bodyCount, const std::string &ext)
+{
+    return baseName + ((bodyCount > 1) ? "." + std::to_string(bodyIdx) : "") + ext;
+}
@@ -0,0 +1,90 @@
+/*
+Copyright (c) 2019, Integrated Design and Engineering Analysis Laboratory (IDEA Lab) at Iowa State University.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef SINK_H
+#define SINK_H
+
+#include <string>
+#include <vector>
+
+#include "common.h"
+#include "shape.h"
+
+
+// Output sink interface, driven by the extraction for each body
+class Sink {
+public:
+    virtual ~Sink() {}
+
+    // Start and finish writing the surfaces of a body
+    virtual bool beginShape(int, int) = 0;
+    virtual bool endShape() = 0;
+
+    // Write the surface and then its trim loops (if trim curves are extracted)
+    virtual bool writeSurface(Surface &) = 0;
+    virtual bool writeTrims(std::vector<TrimLoop> &) = 0;
+
+    // Record a face which is skipped, e.g. failed or out of time
+    virtual bool skipFace(int, const std::string &) = 0;
+
+    // Names of the files written so far
+    const std::vector<std::string> &outputFiles() const { return files; }
+
+protected:
+    std::vector<std::string> files;
+};
+
+// Sink collecting the shapes in memory
+class MemorySink : public Sink {
+public:
+    explicit MemorySink(std::vector<Shape> &);
+
+    bool beginShape(int, int);
+    bool endShape();
+    bool writeSurface(Surface &);
+    bool writeTrims(std::vector<TrimLoop> &);
+    bool skipFace(int, const std::string &);
+
+private:
+    std::vector<Shape> &shapes;
+};
+
+// Sink discarding the output (e.g. for benchmarking the extraction)
+class NullSink : public Sink {
+public:
+    bool beginShape(int, int);
+    bool endShape();
+    bool writeSurface(Surface &);
+    bool writeTrims(std::vector<TrimLoop> &);
+    bool skipFace(int, const std::string &);
+};
+
+// Function prototypes
+Sink *createSink(Config &, const std::string &);
+std::string outputFileName(const std::string &, int, int, const std::string &);
+
+#endif /* SINK_H */
@@ -0,0 +1,208 @@
+/*
+Copyright (c) 2019, Integrated Design and Engineering Analysis Laboratory (IDEA Lab) at Iowa State University.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "sink_json.h"
+#include "log.h"
+#include "perf.h"
+
+
+JsonSink::JsonSink(const std::string &base) : baseName(base), count(0), pending(false)
+{
+}
+
+bool JsonSink::beginShape(int bodyIdx, int bodyCount)
+{
+    fileName = outputFileName(baseName, bodyIdx, bodyCount, ".json");
+    count = 0;
+    skipped.clear();
+    pending = false;
+    dataDef = Json::Value();
+    return true;
+}
+
+bool JsonSink::endShape()
+{
+    flushSurface();
+
+    // Try to open JSON file for writing
+    beginPhase(PHASE_WRITE);
+    std::ofstream fileSave(fileName.c_str(), std::ios::out);
+    endPhase();
+    if (!fileSave)
+    {
+        logMessage(LOG_ERROR, "file", "Cannot open file '" + fileName + "' for writing!");
+        return false;
+    }
+
+    // Create the root JSON object
+    beginPhase(PHASE_SERIALIZE);
+    Json::Value shapeDef;
+    shapeDef["type"] = "surface";
+    shapeDef["count"] = count;
+    shapeDef["data"] = dataDef;
+    if (!skipped.empty())
+        serializeSkipped(skipped, shapeDef["skipped"]);
+    Json::Value root;
+    root["shape"] = shapeDef;
+
+    // Convert JSON data structure into a string
+    Json::StreamWriterBuilder wbuilder;
+    wbuilder["indentation"] = "\t";
+    std::string jsonDocument = Json::writeString(wbuilder, root);
+    endPhase();
+
+    // Write JSON string to a file
+    beginPhase(PHASE_WRITE);
+    fileSave << jsonDocument << std::endl;
+    fileSave.close();
+    endPhase();
+
+    // Free the surface data
+    dataDef = Json::Value();
+
+    // Closing flushes the file, a full disk is detected by either
+    if (!fileSave)
+    {
+        logMessage(LOG_ERROR, "file", "Cannot write to file '" + fileName + "'!");
+        return false;
+    }
+
+    // Print success message
+    logMessage(LOG_SUCCESS, "output", "Data was extracted to file '" + fileName + "' successfully");
+    files.push_back(fileName);
+
+    return true;
+}
+
+bool JsonSink::writeSurface(Surface &surf)
+{
+    if (!flushSurface())
+        return false;
+    PhaseScope serializePhase(PHASE_SERIALIZE);
+    surfDef = Json::Value();
+    serializeSurface(surf, surfDef);
+    pending = true;
+    return true;
+}
+
+bool JsonSink::writeTrims(std::vector<TrimLoop> &trims)
+{
+    PhaseScope serializePhase(PHASE_SERIALIZE);
+    Json::Value surfTrimDef;
+    serializeTrims(trims, surfTrimDef);
+    surfDef["trims"] = surfTrimDef;
+    return true;
+}
+
+bool JsonSink::skipFace(int faceIdx, const std::string &reason)
+{
+    SkippedFace face;
+    face.face = faceIdx;
+    face.reason = reason;
+    skipped.push_back(face);
+    return true;
+}
+
+bool JsonSink::flushSurface()
+{
+    if (pending)
+    {
+        PhaseScope serializePhase(PHASE_SERIALIZE);
+        dataDef.append(surfDef);
+        count++;
+        pending = false;
+    }
+    return true;
+}
+
+JsonStreamSink::JsonStreamSink(const std::string &base) : JsonSink(base)
+{
+    Json::StreamWriterBuilder wbuilder;
+    wbuilder["indentation"] = "";
+    writer.reset(wbuilder.newStreamWriter());
+}
+
+bool JsonStreamSink::beginShape(int bodyIdx, int bodyCount)
+{
+    JsonSink::beginShape(bodyIdx, bodyCount);
+
+    // Try to open JSON file for writing
+    fileSave.open(fileName.c_str(), std::ios::out);
+    if (!fileSave)
+    {
+        logMessage(LOG_ERROR, "file", "Cannot open file '" + fileName + "' for writing!");
+        return false;
+    }
+
+    // Surfaces are written before the count is known
+    fileSave << "{\"shape\":{\"type\":\"surface\",\"data\":[";
+    return true;
+}
+
+bool JsonStreamSink::endShape()
+{
+    flushSurface();
+
+    // Close the data array, add the skipped faces and close the root object
+    beginPhase(PHASE_WRITE);
+    fileSave << "\n],\"count\":" << count;
+    if (!skipped.empty())
+    {
+        Json::Value skippedDef;
+        serializeSkipped(skipped, skippedDef);
+        fileSave << ",\"skipped\":";
+        writer->write(skippedDef, &fileSave);
+    }
+    fileSave << "}}" << std::endl;
+    bool retVal = bool(fileSave);
+    fileSave.close();
+    endPhase();
+    if (!retVal)
+    {
+        logMessage(LOG_ERROR, "file", "Cannot write to file '" + fileName + "'!");
+        return false;
+    }
+
+    // Print success message
+    logMessage(LOG_SUCCESS, "output", "Data was extracted to file '" + fileName + "' successfully");
+    files.push_back(fileName);
+
+    return true;
+}
+
+bool JsonStreamSink::flushSurface()
+{
+    if (pending)
+    {
+        PhaseScope writePhase(PHASE_WRITE);
+        fileSave << ((count > 0) ? ",\n" : "\n");
+        writer->write(surfDef, &fileSave);
+        count++;
+        pending = false;
+    }
+    return bool(fileSave);
+}
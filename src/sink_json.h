@@ -0,0 +1,84 @@
+/*
+Copyright (c) 2019, Integrated Design and Engineering Analysis Laboratory (IDEA Lab) at Iowa State University.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef SINK_JSON_H
+#define SINK_JSON_H
+
+#include <fstream>
+#include <memory>
+
+#include "sink.h"
+#include "serialize.h"
+
+
+// Sink writing each shape to a geomdl JSON file after all of its surfaces are extracted
+class JsonSink : public Sink {
+public:
+    explicit JsonSink(const std::string &);
+
+    bool beginShape(int, int);
+    bool endShape();
+    bool writeSurface(Surface &);
+    bool writeTrims(std::vector<TrimLoop> &);
+    bool skipFace(int, const std::string &);
+
+protected:
+    std::string baseName;
+    std::string fileName;
+    int count;
+
+    // Faces skipped in the current shape
+    std::vector<SkippedFace> skipped;
+
+    // The surface is kept until its trims are written
+    Json::Value surfDef;
+    bool pending;
+
+    // Write the pending surface
+    virtual bool flushSurface();
+
+private:
+    Json::Value dataDef;
+};
+
+// Sink streaming the surfaces to a geomdl JSON file as they are extracted (compact, one surface per line)
+class JsonStreamSink : public JsonSink {
+public:
+    explicit JsonStreamSink(const std::string &);
+
+    bool beginShape(int, int);
+    bool endShape();
+
+protected:
+    bool flushSurface();
+
+private:
+    std::ofstream fileSave;
+    std::unique_ptr<Json::StreamWriter> writer;
+};
+
+#endif /* SINK_JSON_H */
@@ -0,0 +1,253 @@
+/*
+Copyright (c) 2019, Integrated Design and Engineering Analysis Laboratory (IDEA Lab) at Iowa State University.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "trace.h"
+#include "log.h"
+
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <functional>
+#include <cstdio>
+
+#ifdef _MSC_VER
+#include <process.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#endif
+
+
+// Completed trace event (times in microseconds of the monotonic clock, comparable between the processes)
+struct TraceEvent {
+    std::string name;
+    const char *category;
+    long long start;
+    long long duration;
+    long long tid;
+};
+
+// Open trace event of a thread
+struct OpenEvent {
+    std::string name;
+    const char *category;
+    long long start;
+};
+
+// Events are written to the file in chunks, the trace file is shared with the child and worker processes
+static const std::size_t flushEvents = 65536;
+
+// Recording state
+static bool enabled = false;
+static bool owner = false;
+static std::string fileName;
+static std::mutex eventsMutex;
+static std::vector<TraceEvent> events;
+static thread_local std::vector<OpenEvent> openEvents;
+
+static long long traceClock()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static long long processId()
+{
+#ifdef _MSC_VER
+    return _getpid();
+#else
+    return getpid();
+#endif
+}
+
+static long long threadId()
+{
+#ifdef __linux__
+    return syscall(SYS_gettid);
+#else
+    return (long long)(std::hash<std::thread::id>()(std::this_thread::get_id()) & 0x7fffffff);
+#endif
+}
+
+// Append the text to the trace file in a single write, the other processes append their events to the same file
+static bool appendTrace(const std::string &text)
+{
+#ifdef _MSC_VER
+    std::FILE *fp = std::fopen(fileName.c_str(), "ab");
+    if (fp == NULL)
+        return false;
+    bool retVal = std::fwrite(text.data(), 1, text.size(), fp) == text.size();
+    std::fclose(fp);
+    return retVal;
+#else
+    int fd = open(fileName.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+    if (fd < 0)
+        return false;
+    std::size_t done = 0;
+    while (done < text.size())
+    {
+        ssize_t n = write(fd, text.data() + done, text.size() - done);
+        if (n <= 0)
+            break;
+        done += std::size_t(n);
+    }
+    close(fd);
+    return done == text.size();
+#endif
+}
+
+// Write the recorded events as the elements of the trace event array, each element is followed by a comma
+static void writeEvents(std::vector<TraceEvent> &chunk)
+{
+    if (chunk.empty())
+        return;
+    std::string pid = std::to_string(processId());
+    std::string text;
+    for (std::size_t j = 0; j < chunk.size(); j++)
+    {
+        const TraceEvent &e = chunk[j];
+        text += "{\"name\":\"" + jsonEscape(e.name) + "\",\"cat\":\"" + e.category + "\",\"ph\":\"X\",\"ts\":" + std::to_string(e.start)
+            + ",\"dur\":" + std::to_string(e.duration) + ",\"pid\":" + pid + ",\"tid\":" + std::to_string(e.tid) + "},\n";
+    }
+    if (!appendTrace(text))
+        logMessage(LOG_ERROR, "file", "Cannot write to file '" + fileName + "'!");
+    chunk.clear();
+}
+
+// Start recording if the 'trace' option is set, the main process creates the trace file
+// (the worker processes of the batch driver append to the trace file of the driver)
+void configureTrace(Config &cfg)
+{
+    fileName = cfg.trace();
+    enabled = !fileName.empty();
+    owner = (cfg.worker() == 0);
+    if (!enabled || !owner)
+        return;
+
+    std::FILE *fp = std::fopen(fileName.c_str(), "wb");
+    if (fp == NULL)
+    {
+        logMessage(LOG_ERROR, "file", "Cannot open file '" + fileName + "' for writing!");
+        enabled = false;
+        return;
+    }
+    std::fputs("[\n", fp);
+    std::fclose(fp);
+}
+
+bool traceEnabled()
+{
+    return enabled;
+}
+
+void beginTrace(const std::string &name, const char *category)
+{
+    if (!enabled)
+        return;
+    OpenEvent e;
+    e.name = name;
+    e.category = category;
+    e.start = traceClock();
+    openEvents.push_back(e);
+}
+
+void endTrace()
+{
+    if (!enabled || openEvents.empty())
+        return;
+    const OpenEvent &open = openEvents.back();
+    TraceEvent e;
+    e.name = open.name;
+    e.category = open.category;
+    e.start = open.start;
+    e.duration = traceClock() - open.start;
+    e.tid = threadId();
+    openEvents.pop_back();
+
+    std::vector<TraceEvent> chunk;
+    {
+        std::lock_guard<std::mutex> lock(eventsMutex);
+        events.push_back(e);
+        if (events.size() < flushEvents)
+            return;
+        chunk.swap(events);
+    }
+    writeEvents(chunk);
+}
+
+// Write the recorded events, e.g. before a child process exits
+void flushTrace()
+{
+    if (!enabled)
+        return;
+    std::vector<TraceEvent> chunk;
+    {
+        std::lock_guard<std::mutex> lock(eventsMutex);
+        chunk.swap(events);
+    }
+    writeEvents(chunk);
+}
+
+// Write the remaining events and close the trace event array, the child and worker processes must be finished
+void finishTrace()
+{
+    if (!enabled)
+        return;
+    flushTrace();
+    if (!owner)
+        return;
+
+    // The process name is the last element, it is not followed by a comma
+    std::string text = "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" + std::to_string(processId()) + ",\"args\":{\"name\":\"rwsat\"}}\n]\n";
+    if (!appendTrace(text))
+        logMessage(LOG_ERROR, "file", "Cannot write to file '" + fileName + "'!");
+    enabled = false;
+}
+
+TraceScope::TraceScope(const char *name, const char *category) : active(enabled)
+{
+    if (active)
+        beginTrace(name, category);
+}
+
+TraceScope::TraceScope(const char *name, int index, const char *category) : active(enabled)
+{
+    if (active)
+        beginTrace(std::string(name) + " #" + std::to_string(index), category);
+}
+
+TraceScope::TraceScope(const std::string &name, const char *category) : active(enabled)
+{
+    if (active)
+        beginTrace(name, category);
+}
+
+TraceScope::~TraceScope()
+{
+    if (active)
+        endTrace();
+}
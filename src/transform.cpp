@@ -0,0 +1,78 @@
+/*
+Copyright (c) 2019, Integrated Design and Engineering Analysis Laboratory (IDEA Lab) at Iowa State University.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of the copyright holder nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "transform.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RWSAT_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+
+// Apply the 3x4 row-major affine matrix to the array of points stored as (x, y, z) triplets
+void transformPoints(const double *m, double *pts, int numPts)
+{
+#ifdef RWSAT_USE_SSE2
+    // Columns of the matrix for the x and y coordinates
+    __m128d c0 = _mm_set_pd(m[4], m[0]);
+    __m128d c1 = _mm_set_pd(m[5], m[1]);
+    __m128d c2 = _mm_set_pd(m[6], m[2]);
+    __m128d c3 = _mm_set_pd(m[7], m[3]);
+    // Row of the matrix for the z coordinate
+    __m128d rz01 = _mm_set_pd(m[9], m[8]);
+    __m128d rz23 = _mm_set_pd(m[11], m[10]);
+    __m128d one = _mm_set_sd(1.0);
+
+    for (int i = 0; i < numPts; i++)
+    {
+        double *p = pts + 3 * i;
+        __m128d xy = _mm_loadu_pd(p);
+        __m128d z1 = _mm_unpacklo_pd(_mm_load_sd(p + 2), one);
+
+        // x' and y'
+        __m128d res = _mm_mul_pd(c0, _mm_unpacklo_pd(xy, xy));
+        res = _mm_add_pd(res, _mm_mul_pd(c1, _mm_unpackhi_pd(xy, xy)));
+        res = _mm_add_pd(res, _mm_mul_pd(c2, _mm_unpacklo_pd(z1, z1)));
+        res = _mm_add_pd(res, c3);
+
+        // z'
+        __m128d rz = _mm_add_pd(_mm_mul_pd(rz01, xy), _mm_mul_pd(rz23, z1));
+        rz = _mm_add_sd(rz, _mm_unpackhi_pd(rz, rz));
+
+        _mm_storeu_pd(p, res);
+        _mm_store_sd(p + 2, rz);
+    }
+#else
+    for (int i = 0; i < numPts; i++)
+    {
+        double *p = pts + 3 * i;
+        double x = p[0], y = p[1], z = p[2];
+        for (int r = 0; r < 3; r++)
+            p[r] = m[4 * r] * x + m[4 * r + 1] * y + m[4 * r + 2] * z + m[4 * r + 3];
+    }
+#endif
+}